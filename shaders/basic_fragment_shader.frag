@@ -1,10 +1,10 @@
 #version 460 core
-out vec4 FragColor;
+layout (location = 0) out vec4 FragColor;
 
-in vec3 ourColor;
-in vec2 TexCoord;
+layout (location = 0) in vec3 ourColor;
+layout (location = 1) in vec2 TexCoord;
 
-uniform sampler2D texture1;
+layout (location = 3) uniform sampler2D texture1;
 
 void main()
 {
@@ -1,7 +1,7 @@
 #version 460 core
-out vec4 FragColor;
+layout (location = 0) out vec4 FragColor;
 
-uniform vec3 lightColor;
+layout (location = 2) uniform vec3 lightColor;
 
 void main()
 {
@@ -1,35 +1,44 @@
 #version 460 core
-out vec4 FragColor;
-
-struct Material
-{
-    sampler2D specular;
-    sampler2D diffuse;
-    float shininess;
-};
-
-struct Light
-{
-    vec3 position;
-
-    vec3 ambient;
-    vec3 specular;
-    vec3 diffuse;
-};
-
-in vec3 Normal;
-in vec3 FragPos;
-in vec2 TexCoords;
-
-uniform vec3 viewPos;
-
-uniform Material material;
-uniform Light light;
+// BINDLESS is injected when the context has bindless textures, see material.glsl
+#ifdef BINDLESS
+#extension GL_ARB_bindless_texture : require
+#endif
+layout (location = 0) out vec4 FragColor;
+
+#include "include/frame_data.glsl"
+#include "include/material.glsl"
+#include "include/draw_objects.glsl"
+#include "include/virtual_texture.glsl"
+
+layout (location = 0) in vec3 Normal;
+layout (location = 1) in vec3 FragPos;
+layout (location = 2) in vec2 TexCoords;
+layout (location = 3) flat in int DrawMaterial;
 
 void main()
 {
-    vec3 diffuseAmbient = vec3(texture(material.diffuse, TexCoords));
-    vec3 specularMap = vec3(texture(material.specular, TexCoords));
+    // the same for the whole draw either way, so bindless handles stay uniform
+    Material material = materials[GPU_DRIVEN != 0 ? DrawMaterial : materialIndex];
+
+    // the virtual texture replaces the material's diffuse map, folded like SPECULAR_MAP
+    vec3 diffuseAmbient;
+    if(VIRTUAL_TEXTURE != 0)
+    {
+        diffuseAmbient = vec3(sampleVirtualTexture(TexCoords));
+    }
+    else
+    {
+        diffuseAmbient = vec3(sampleMaterialMap(material.diffuseHandle, material.diffuseLayer, material.diffuseRect,
+                                                TexCoords));
+    }
+
+    // variants without specular maps use a constant color, the check is folded when compiling/specializing
+    vec3 specularMap = material.specularColor;
+    if(SPECULAR_MAP != 0 && material.specularLayer >= 0)
+    {
+        specularMap = vec3(sampleMaterialMap(material.specularHandle, material.specularLayer, material.specularRect,
+                                            TexCoords));
+    }
 
     // normal of current fragment in world space
     vec3 normal = normalize(Normal);
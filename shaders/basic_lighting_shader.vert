@@ -3,20 +3,25 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat3 normalMat;
+#include "include/transform.glsl"
 
-out vec3 Normal;
-out vec3 FragPos;
-out vec2 TexCoords;
+// separable stages are matched by location, and the built-in block must be redeclared
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+layout (location = 0) out vec3 Normal;
+layout (location = 1) out vec3 FragPos;
+layout (location = 2) out vec2 TexCoords;
+// with GPU_DRIVEN the commands are one per material, so the draw id is the material
+layout (location = 3) flat out int DrawMaterial;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    FragPos = vec3(model * vec4(aPos, 1));
-    Normal = normalMat * aNormal;
+    gl_Position = modelToClip(aPos);
+    FragPos = vec3(modelMatrix() * vec4(aPos, 1));
+    Normal = normalMatrix() * aNormal;
     TexCoords = aTexCoord;
+    DrawMaterial = gl_DrawID;
 }
-
@@ -0,0 +1,33 @@
+// every object of the gpu driven path, uploaded once. the cull compute shader lists the visible ones per
+// material, and each material is one command of a multi draw indirect. a specialization constant when
+// compiled to SPIR-V, an injected #define (0 unless set) when compiled from text
+#ifdef GL_SPIRV
+layout (constant_id = 3) const int GPU_DRIVEN = 0;
+#elif !defined(GPU_DRIVEN)
+#define GPU_DRIVEN 0
+#endif
+
+// std430, mirrored by DrawObject in IndirectDraws.h
+struct DrawObject
+{
+    mat4 model;
+    // a mat4 so the columns have the same padding in C++, only the upper 3x3 is used
+    mat4 normalMat;
+    // world space center and radius
+    vec4 boundingSphere;
+    uint material;
+    uint _pad0;
+    uint _pad1;
+    uint _pad2;
+};
+
+layout (std430, binding = 0) readonly buffer DrawObjects
+{
+    DrawObject objects[];
+};
+
+// indices into objects, the instances of command i start at its baseInstance
+layout (std430, binding = 1) buffer VisibleObjects
+{
+    uint visibleObjects[];
+};
@@ -0,0 +1,19 @@
+struct Light
+{
+    vec3 position;
+
+    vec3 ambient;
+    vec3 specular;
+    vec3 diffuse;
+};
+
+// written once per frame, shared by every program
+layout (std140, binding = 0) uniform FrameData
+{
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+    Light light;
+    // the camera's frustum as (inward normal, distance), for culling on the gpu
+    vec4 frustumPlanes[6];
+};
@@ -0,0 +1,53 @@
+// picks the specular map over specularColor. a specialization constant when compiled to SPIR-V,
+// an injected #define (0 unless set) when compiled from text
+#ifdef GL_SPIRV
+layout (constant_id = 0) const int SPECULAR_MAP = 0;
+#elif !defined(SPECULAR_MAP)
+#define SPECULAR_MAP 0
+#endif
+
+struct Material
+{
+    // rectangles of the maps in their layer of materialMaps: xy offset, zw size, in uv
+    vec4 diffuseRect;
+    vec4 specularRect;
+    int diffuseLayer;
+    // -1 without a specular map
+    int specularLayer;
+
+    // bindless handles of the maps when they are textures of their own (with BINDLESS), 0 otherwise
+    uvec2 diffuseHandle;
+    uvec2 specularHandle;
+
+    // used instead of the specular map when there is none
+    vec3 specularColor;
+    float shininess;
+};
+
+// every material at once, uploaded when they change. draws pick theirs with materialIndex
+layout (std140, binding = 1) uniform MaterialData
+{
+    Material materials[16];
+};
+
+// the current draw's entry in materials
+layout (location = 3) uniform int materialIndex;
+
+#ifdef BINDLESS
+// every map is a texture of its own, sampled through the handle its material stores (layer and rect unused).
+// materialIndex is uniform for the draw, so the handle is too
+vec4 sampleMaterialMap(uvec2 handle, int layer, vec4 rect, vec2 uv)
+{
+    return texture(sampler2D(handle), uv);
+}
+#else
+// the maps of all materials in one array texture, so switching materials binds nothing.
+// explicit locations, SPIR-V modules don't get them assigned by name
+layout (location = 2) uniform sampler2DArray materialMaps;
+
+// uv over the whole map -> its rectangle. only maps with a layer of their own repeat
+vec4 sampleMaterialMap(uvec2 handle, int layer, vec4 rect, vec2 uv)
+{
+    return texture(materialMaps, vec3(rect.xy + uv * rect.zw, layer));
+}
+#endif
@@ -0,0 +1,47 @@
+#include "frame_data.glsl"
+#include "draw_objects.glsl"
+
+// takes the model and normal matrices from per instance attributes instead of uniforms. a specialization
+// constant when compiled to SPIR-V, an injected #define (0 unless set) when compiled from text
+#ifdef GL_SPIRV
+layout (constant_id = 2) const int INSTANCED = 0;
+#elif !defined(INSTANCED)
+#define INSTANCED 0
+#endif
+
+layout (location = 0) uniform mat4 model;
+layout (location = 1) uniform mat3 normalMat;
+
+// one per instance from the instance buffer, a location per column
+layout (location = 3) in mat4 instanceModel;
+layout (location = 7) in mat3 instanceNormalMat;
+
+// with GPU_DRIVEN the draw's instances are the visible objects its command was given
+uint drawObject()
+{
+    return visibleObjects[gl_BaseInstance + gl_InstanceID];
+}
+
+mat4 modelMatrix()
+{
+    if(GPU_DRIVEN != 0)
+    {
+        return objects[drawObject()].model;
+    }
+    return INSTANCED != 0 ? instanceModel : model;
+}
+
+mat3 normalMatrix()
+{
+    if(GPU_DRIVEN != 0)
+    {
+        return mat3(objects[drawObject()].normalMat);
+    }
+    return INSTANCED != 0 ? instanceNormalMat : normalMat;
+}
+
+// object space position to clip space
+vec4 modelToClip(vec3 position)
+{
+    return projection * view * modelMatrix() * vec4(position, 1.0);
+}
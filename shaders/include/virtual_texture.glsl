@@ -0,0 +1,94 @@
+// lets the lit shader take its diffuse color from the virtual texture. a specialization constant when
+// compiled to SPIR-V, an injected #define (0 unless set) when compiled from text
+#ifdef GL_SPIRV
+layout (constant_id = 1) const int VIRTUAL_TEXTURE = 0;
+#elif !defined(VIRTUAL_TEXTURE)
+#define VIRTUAL_TEXTURE 0
+#endif
+
+// the virtual texture's layout, written when it's created
+layout (std140, binding = 2) uniform VirtualTextureData
+{
+    // texels of level 0, powers of two
+    vec2 virtualSize;
+    // pages of level 0
+    vec2 pageCount;
+    // texels per side of a page
+    float pageSize;
+    // texels around each page in the cache, copies of its neighbours so filtering doesn't bleed
+    float pageBorder;
+    // texels per side of the page cache
+    float cacheSize;
+    // levels in the page table, the coarsest one is always resident
+    int pageLevels;
+    // 1: pageStorage is a sparse texture sampled directly, 0: it is the page cache
+    int sparse;
+    // the feedback buffer is smaller than the screen, its derivatives are bigger by as much
+    float feedbackLodBias;
+};
+
+// a texel per page of each level: rg slot of the page in the cache, b the level the data comes from
+// (the page's own, or the closest coarser one that is resident)
+layout (location = 4) uniform usampler2D pageTable;
+layout (location = 5) uniform sampler2D pageStorage;
+
+float virtualTextureLod(vec2 uv)
+{
+    vec2 dx = dFdx(uv * virtualSize);
+    vec2 dy = dFdy(uv * virtualSize);
+    return 0.5 * log2(max(dot(dx, dx), dot(dy, dy)));
+}
+
+// xy page, z level that lod wants, clamped to the levels in the page table. uv repeats
+ivec3 virtualTexturePage(vec2 uv, float lod)
+{
+    int level = clamp(int(floor(lod)), 0, pageLevels - 1);
+    ivec2 pages = max(ivec2(pageCount) >> level, ivec2(1));
+    return ivec3(min(ivec2(fract(uv) * vec2(pages)), pages - 1), level);
+}
+
+// the bilinear taps reach half a texel of the level past uv, and the next level's a whole texel of this one,
+// which can be in neighbouring pages that aren't committed. the level goes up until every page the footprint
+// touches has it resident. a page's coarser levels are resident too, so this ends at the coarsest level
+float sparseFilterLevel(vec2 uv, float level)
+{
+    for(int i = 0; i < pageLevels; i++)
+    {
+        vec2 footprint = exp2(floor(level)) / virtualSize;
+        float needed = level;
+        for(int corner = 0; corner < 4; corner++)
+        {
+            vec2 offset = vec2(corner & 1, corner >> 1) * 2.0 - 1.0;
+            ivec3 page = virtualTexturePage(uv + offset * footprint, level);
+            needed = max(needed, float(texelFetch(pageTable, page.xy, page.z).b));
+        }
+
+        if(needed == level)
+        {
+            break;
+        }
+        level = needed;
+    }
+    return level;
+}
+
+vec4 sampleVirtualTexture(vec2 uv)
+{
+    float lod = virtualTextureLod(uv);
+    ivec3 page = virtualTexturePage(uv, lod);
+    uvec4 entry = texelFetch(pageTable, page.xy, page.z);
+    float residentLevel = float(entry.b);
+
+    // committed pages only, coarser levels of a resident page are resident too
+    if(sparse != 0)
+    {
+        return textureLod(pageStorage, uv, sparseFilterLevel(uv, max(lod, residentLevel)));
+    }
+
+    // levels narrower than a page fill only part of it
+    vec2 levelSize = max(virtualSize / exp2(residentLevel), vec2(1.0));
+    vec2 extent = min(vec2(pageSize), levelSize);
+    vec2 inPage = fract(fract(uv) * levelSize / extent);
+    vec2 texel = vec2(entry.rg) * (pageSize + 2.0 * pageBorder) + pageBorder + inPage * extent;
+    return textureLod(pageStorage, texel / cacheSize, 0.0);
+}
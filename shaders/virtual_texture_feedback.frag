@@ -0,0 +1,13 @@
+#version 460 core
+// page each fragment would sample, drawn into a small buffer that is read back to pick the pages to load
+layout (location = 0) out uint Feedback;
+
+#include "include/virtual_texture.glsl"
+
+layout (location = 2) in vec2 TexCoords;
+
+void main()
+{
+    ivec3 page = virtualTexturePage(TexCoords, virtualTextureLod(TexCoords) + feedbackLodBias);
+    Feedback = uint(page.x) | (uint(page.y) << 12) | (uint(page.z) << 24);
+}
@@ -0,0 +1,70 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "BindlessTextures.h"
+#include "GLExtensions.h"
+#include "SamplerCache.h"
+
+#include <iostream>
+
+std::unordered_map<GLuint, GLuint64> BindlessTextures::resident;
+
+bool BindlessTextures::supported()
+{
+    return GLExtensions::bindlessTexture;
+}
+
+GLuint64 BindlessTextures::handle(GLuint texture)
+{
+    if(!supported() || texture == 0)
+    {
+        return 0;
+    }
+
+    auto found = resident.find(texture);
+    if(found != resident.end())
+    {
+        return found->second;
+    }
+
+    // the handle is the same for the texture's whole lifetime, residency is what costs
+    // paired with the default sampler, the texture itself has no sampling state
+    GLuint64 handle = GLExtensions::glGetTextureSamplerHandleARB(texture, SamplerCache::get(SamplerCache::defaults));
+    if(handle == 0)
+    {
+        std::cout << "ERROR::BINDLESS::NO_HANDLE for texture " << texture << '\n';
+        return 0;
+    }
+
+    GLExtensions::glMakeTextureHandleResidentARB(handle);
+    resident.emplace(texture, handle);
+    return handle;
+}
+
+void BindlessTextures::release(GLuint texture)
+{
+    auto found = resident.find(texture);
+    if(found == resident.end())
+    {
+        return;
+    }
+
+    GLExtensions::glMakeTextureHandleNonResidentARB(found->second);
+    resident.erase(found);
+}
+
+glm::uvec2 BindlessTextures::pack(GLuint64 handle)
+{
+    return {(GLuint) (handle & 0xFFFFFFFFu), (GLuint) (handle >> 32)};
+}
+
+bool BindlessTextures::has(GLuint texture)
+{
+    return resident.count(texture) != 0;
+}
+
+std::size_t BindlessTextures::residentCount()
+{
+    return resident.size();
+}
@@ -0,0 +1,44 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_BINDLESSTEXTURES_H
+#define LEARNOPENGL_BINDLESSTEXTURES_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <unordered_map>
+
+// 64-bit handles for sampling textures without binding them to units (ARB_bindless_texture).
+// a texture's handle is created and made resident the first time it's asked for, and has to be
+// released before the texture is deleted. handles pair the texture with the SamplerCache::defaults sampler,
+// changing the defaults later doesn't affect textures that already have one
+class BindlessTextures
+{
+public:
+    // the capability check, bind textures to units when this is false
+    [[nodiscard]] static bool supported();
+
+    // resident handle of texture, 0 when bindless isn't supported or texture is 0
+    static GLuint64 handle(GLuint texture);
+
+    // makes the texture's handle non resident and forgets it, call before deleting the texture
+    static void release(GLuint texture);
+
+    // low and high half, how handles are stored in uniform blocks (a uvec2 turned into a sampler in glsl)
+    static glm::uvec2 pack(GLuint64 handle);
+
+    // the texture has a resident handle, so its storage must not change
+    [[nodiscard]] static bool has(GLuint texture);
+
+    // textures whose handles are resident right now
+    [[nodiscard]] static std::size_t residentCount();
+
+private:
+    // texture name -> its resident handle
+    static std::unordered_map<GLuint, GLuint64> resident;
+};
+
+#endif //LEARNOPENGL_BINDLESSTEXTURES_H
@@ -4,37 +4,46 @@
 
 #include "Camera.h"
 
+#include <cmath>
+
 Camera::Camera(glm::vec3 position, glm::vec3 up, float pitch, float yaw)
-    : m_cameraPos(position), m_cameraUp(up), m_pitch(pitch), m_yaw(yaw)
+    : m_yaw(yaw), m_pitch(pitch)
 {
-
+    m_cached.position = position;
+    m_cached.up = up;
 }
 
 float Camera::getPitch() const {return m_pitch;};
 float Camera::getYaw() const {return m_yaw;};
 
-glm::vec3 Camera::getCameraDir()
+const glm::vec3& Camera::getCameraDir()
 {
     updateVectors();
-    return m_cameraDir;
+    return m_cached.direction;
+};
+
+const glm::vec3& Camera::getCameraPos() const
+{
+    return m_cached.position;
 };
 
-glm::vec3 Camera::getCameraPos()
+const glm::vec3& Camera::getCameraRight()
 {
-    return m_cameraPos;
+    updateVectors();
+    return m_cached.right;
 };
 
-glm::vec3 Camera::getCameraRight()
+const glm::vec3& Camera::getCameraUp()
 {
     updateVectors();
-    return m_cameraRight;
+    return m_cached.up;
 };
 
 void Camera::setPitch(float pitch) {
     if(pitch > -89 && pitch < 89)
     {
         m_pitch = pitch;
-        updateVectors();
+        m_dirty |= ROTATION;
     }
 };
 void Camera::setYaw(float yaw)
@@ -50,11 +59,16 @@ void Camera::setYaw(float yaw)
         m_yaw = 360 + m_yaw;
     }
 
-    updateVectors();
+    m_dirty |= ROTATION;
 };
 
 void Camera::changeYaw(float yawOffset)
 {
+    if(yawOffset == 0)
+    {
+        return;
+    }
+
     m_yaw += yawOffset;
 
     if(m_yaw > 360)
@@ -66,9 +80,14 @@ void Camera::changeYaw(float yawOffset)
         m_yaw = 360 + m_yaw;
     }
 
-    updateVectors();
+    m_dirty |= ROTATION;
 };
 void Camera::changePitch(float pitchOffset) {
+    if(pitchOffset == 0)
+    {
+        return;
+    }
+
     m_pitch += pitchOffset;
     if(m_pitch > 89.0)
     {
@@ -79,28 +98,138 @@ void Camera::changePitch(float pitchOffset) {
         m_pitch = -89;
     }
 
-    updateVectors();
+    m_dirty |= ROTATION;
+};
+
+void Camera::setCameraPos(const glm::vec3 &newPos)
+{
+    m_cached.position = newPos;
+    m_dirty |= POSITION;
 };
+void Camera::changeCameraPos(const glm::vec3 &posOffset)
+{
+    m_cached.position += posOffset;
+    m_dirty |= POSITION;
+};
+
+void Camera::setPerspective(float fovDegrees, float aspect, float nearPlane, float farPlane)
+{
+    if(fovDegrees == m_fov && aspect == m_aspect && nearPlane == m_near && farPlane == m_far)
+    {
+        return;
+    }
+
+    m_fov = fovDegrees;
+    m_aspect = aspect;
+    m_near = nearPlane;
+    m_far = farPlane;
+    m_dirty |= PROJECTION | VIEW_PROJECTION;
+}
+
+void Camera::setDepthMode(DepthMode mode)
+{
+    if(mode != m_depthMode)
+    {
+        m_depthMode = mode;
+        m_dirty |= PROJECTION | VIEW_PROJECTION;
+    }
+}
 
-void Camera::setCameraPos(const glm::vec3 &newPos) {m_cameraPos = newPos;};
-void Camera::changeCameraPos(const glm::vec3 &posOffset) {m_cameraPos += posOffset;};
+Camera::DepthMode Camera::getDepthMode() const {return m_depthMode;};
 
 void Camera::updateVectors()
 {
+    if(!(m_dirty & VECTORS))
+    {
+        return;
+    }
+
     glm::vec3 direction;
     direction.x = cos(glm::radians(m_yaw)) * cos(glm::radians(m_pitch));
     direction.y = sin(glm::radians(m_pitch));
     direction.z = sin(glm::radians(m_yaw)) * cos(glm::radians(m_pitch));
-    m_cameraDir = glm::normalize(direction);
+    m_cached.direction = glm::normalize(direction);
 
-    m_cameraRight = glm::normalize(glm::cross(m_cameraDir, worldUp));
-    m_cameraUp = glm::normalize(glm::cross(m_cameraDir, m_cameraRight));
+    m_cached.right = glm::normalize(glm::cross(m_cached.direction, worldUp));
+    m_cached.up = glm::normalize(glm::cross(m_cached.direction, m_cached.right));
+    m_dirty &= ~VECTORS;
 }
 
 const glm::mat4& Camera::getView()
 {
-    return glm::lookAt(m_cameraPos, m_cameraPos + m_cameraDir, m_cameraUp);
+    if(m_dirty & VIEW)
+    {
+        updateVectors();
+        m_cached.view = glm::lookAt(m_cached.position, m_cached.position + m_cached.direction, m_cached.up);
+        m_dirty &= ~VIEW;
+    }
+    return m_cached.view;
 }
 
+const glm::mat4& Camera::getProjection()
+{
+    if(m_dirty & PROJECTION)
+    {
+        if(m_depthMode == DepthMode::REVERSE_Z)
+        {
+            // clip z is the near distance and w the view distance, so depth = near / distance:
+            // 1 at the near plane, approaching 0 towards infinity
+            const float focal = 1.0f / std::tan(glm::radians(m_fov) * 0.5f);
+            m_cached.projection = glm::mat4(0.0f);
+            m_cached.projection[0][0] = focal / m_aspect;
+            m_cached.projection[1][1] = focal;
+            m_cached.projection[2][3] = -1.0f;
+            m_cached.projection[3][2] = m_near;
+        }
+        else
+        {
+            m_cached.projection = glm::perspective(glm::radians(m_fov), m_aspect, m_near, m_far);
+        }
+        m_dirty &= ~PROJECTION;
+    }
+    return m_cached.projection;
+}
 
+const glm::mat4& Camera::getViewProjection()
+{
+    if(m_dirty & VIEW_PROJECTION)
+    {
+        m_cached.viewProjection = getProjection() * getView();
+        m_cached.frustum = extractFrustum(m_cached.viewProjection, m_depthMode == DepthMode::REVERSE_Z);
+        m_dirty &= ~VIEW_PROJECTION;
+    }
+    return m_cached.viewProjection;
+}
+
+const Camera::Frustum& Camera::getFrustum()
+{
+    getViewProjection();
+    return m_cached.frustum;
+}
+
+const Camera::Snapshot& Camera::snapshot()
+{
+    // view projection pulls in everything else
+    getViewProjection();
+    return m_cached;
+}
+
+Camera::Frustum Camera::extractFrustum(const glm::mat4& viewProjection, bool zeroToOne)
+{
+    // glm is column major, row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+    auto row = [&viewProjection](int i)
+    {
+        return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    };
 
+    // clip space: -w <= x, y <= w and -w <= z <= w, or 0 <= z <= w. with reverse-Z z <= w is the near plane
+    Frustum frustum {{row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1),
+                      zeroToOne ? row(3) - row(2) : row(3) + row(2), zeroToOne ? row(2) : row(3) - row(2)}};
+    for(glm::vec4& plane : frustum.planes)
+    {
+        float length = glm::length(glm::vec3(plane));
+        // z >= 0 of an infinite projection has no normal, it rejects nothing
+        plane = length > 1e-6f ? plane / length : glm::vec4(0, 0, 0, 1);
+    }
+    return frustum;
+}
@@ -8,14 +8,58 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+// direction vectors and matrices are cached and only recomputed, at most once, after something
+// they depend on changed. getters bring the cache up to date, so they're not const
 class Camera
 {
 public:
 
+    // STANDARD maps near..far to -1..1 (the GL default). REVERSE_Z maps near to 1 and an infinite far plane to 0,
+    // for clip control GL_ZERO_TO_ONE, a GL_GREATER depth test and a float depth buffer cleared to 0
+    enum class DepthMode
+    {
+        STANDARD,
+        REVERSE_Z
+    };
+
+    // planes of the view volume as (normal, distance), normals unit length and pointing inside:
+    // dot(normal, point) + distance >= 0 for points in front of a plane. left, right, bottom, top, near, far.
+    // an infinite far plane is (0, 0, 0, 1), nothing is behind it
+    struct Frustum
+    {
+        glm::vec4 planes[6];
+    };
+
+    // everything the renderer reads from the camera, copied out once per frame so other threads can
+    // read it without touching (or recomputing) the camera itself
+    struct Snapshot
+    {
+        glm::vec3 position;
+        glm::vec3 direction;
+        glm::vec3 right;
+        glm::vec3 up;
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::mat4 viewProjection;
+        // extracted from viewProjection whenever it's recomputed
+        Frustum frustum;
+    };
+
     explicit Camera(glm::vec3 position = glm::vec3(0, 0, -3), glm::vec3 up = glm::vec3(0, 1, 0),
             float pitch = 0, float yaw = 270);
 
     const glm::mat4& getView();
+    const glm::mat4& getProjection();
+    const glm::mat4& getViewProjection();
+    const Frustum& getFrustum();
+
+    // only marks the projection dirty when a value actually changed. farPlane is ignored with REVERSE_Z
+    void setPerspective(float fovDegrees, float aspect, float nearPlane, float farPlane);
+    void setDepthMode(DepthMode mode);
+    [[nodiscard]] DepthMode getDepthMode() const;
+
+    // every cached value up to date
+    const Snapshot& snapshot();
 
     void setYaw(float yaw);
     void setPitch(float pitch);
@@ -29,9 +73,10 @@ public:
     void setCameraPos(const glm::vec3& newPos);
     void changeCameraPos(const glm::vec3& posOffset);
 
-    [[nodiscard]] glm::vec3 getCameraPos();
-    [[nodiscard]] glm::vec3 getCameraDir();
-    [[nodiscard]] glm::vec3 getCameraRight();
+    [[nodiscard]] const glm::vec3& getCameraPos() const;
+    [[nodiscard]] const glm::vec3& getCameraDir();
+    [[nodiscard]] const glm::vec3& getCameraRight();
+    [[nodiscard]] const glm::vec3& getCameraUp();
 
     glm::vec3 worldFront = glm::vec3(0, 0, -1);
     glm::vec3 worldRight = glm::vec3(1, 0, 0);
@@ -41,16 +86,37 @@ public:
     glm::vec3 worldDown = glm::vec3(0, -1, 0);
 
 private:
-    // z values are negative forward and positive backward
-    glm::vec3 m_cameraDir;
-    glm::vec3 m_cameraPos;
-    glm::vec3 m_cameraUp;
-    glm::vec3 m_cameraRight;
-
-    void updateVectors();
+    // what has to be recomputed before it's read again
+    enum Dirty : unsigned int
+    {
+        VECTORS = 1,
+        VIEW = 2,
+        PROJECTION = 4,
+        VIEW_PROJECTION = 8,
+        ROTATION = VECTORS | VIEW | VIEW_PROJECTION,
+        POSITION = VIEW | VIEW_PROJECTION,
+        ALL = VECTORS | VIEW | PROJECTION | VIEW_PROJECTION
+    };
+
+    // z values are negative forward and positive backward. position, direction, right, up and the
+    // matrices all live in here
+    Snapshot m_cached {};
+    unsigned int m_dirty = ALL;
 
     float m_yaw = 0;
     float m_pitch = -90;
+
+    float m_fov = 45;
+    float m_aspect = 4.0f / 3.0f;
+    float m_near = 0.1f;
+    float m_far = 100;
+    DepthMode m_depthMode = DepthMode::STANDARD;
+
+    void updateVectors();
+
+    // planes from the rows of a view projection matrix (Gribb/Hartmann), for clip space depth in -w..w
+    // or 0..w (zeroToOne)
+    static Frustum extractFrustum(const glm::mat4& viewProjection, bool zeroToOne);
 };
 
 
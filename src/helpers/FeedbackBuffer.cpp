@@ -0,0 +1,145 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "FeedbackBuffer.h"
+#include "VirtualTexture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+FeedbackBuffer::FeedbackBuffer(int scale) : framebuffer(0), width(0), height(0), scale(std::max(scale, 1))
+{
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &requestBuffer);
+    glGenRenderbuffers(1, &depth);
+}
+
+FeedbackBuffer::~FeedbackBuffer()
+{
+    for(Readback& readback : readbacks)
+    {
+        if(readback.fence)
+        {
+            glDeleteSync(readback.fence);
+        }
+        glDeleteBuffers(1, &readback.buffer);
+    }
+    glDeleteRenderbuffers(1, &requestBuffer);
+    glDeleteRenderbuffers(1, &depth);
+    glDeleteFramebuffers(1, &framebuffer);
+}
+
+void FeedbackBuffer::resize(int newWidth, int newHeight)
+{
+    width = newWidth;
+    height = newHeight;
+
+    glBindRenderbuffer(GL_RENDERBUFFER, requestBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_R32UI, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, requestBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "ERROR::FEEDBACK_BUFFER::INCOMPLETE " << width << "x" << height << '\n';
+    }
+}
+
+void FeedbackBuffer::begin(int newScreenWidth, int newScreenHeight, float farDepth)
+{
+    screenWidth = newScreenWidth;
+    screenHeight = newScreenHeight;
+
+    int newWidth = std::max(screenWidth / scale, 1);
+    int newHeight = std::max(screenHeight / scale, 1);
+    if(newWidth != width || newHeight != height)
+    {
+        resize(newWidth, newHeight);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+
+    const GLuint noRequest[4] = {VirtualTexture::NO_REQUEST, 0, 0, 0};
+    glClearBufferuiv(GL_COLOR, 0, noRequest);
+    glClearBufferfv(GL_DEPTH, 0, &farDepth);
+}
+
+void FeedbackBuffer::end(GLuint screenFramebuffer)
+{
+    // nobody read the oldest one in time, it's overwritten
+    if(inFlight == READBACKS)
+    {
+        glDeleteSync(readbacks[oldest].fence);
+        readbacks[oldest].fence = nullptr;
+        oldest = (oldest + 1) % READBACKS;
+        inFlight--;
+    }
+
+    Readback& readback = readbacks[next];
+    if(!readback.buffer)
+    {
+        glGenBuffers(1, &readback.buffer);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    if(readback.width != width || readback.height != height)
+    {
+        readback.width = width;
+        readback.height = height;
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr) width * height * sizeof(GLuint), nullptr, GL_STREAM_READ);
+    }
+
+    // into the buffer, so this returns before the gpu got there
+    glReadPixels(0, 0, width, height, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    next = (next + 1) % READBACKS;
+    inFlight++;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, screenFramebuffer);
+    glViewport(0, 0, screenWidth, screenHeight);
+}
+
+bool FeedbackBuffer::read(std::vector<GLuint>& requests)
+{
+    if(inFlight == 0)
+    {
+        return false;
+    }
+
+    Readback& readback = readbacks[oldest];
+    if(glClientWaitSync(readback.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+    {
+        return false;
+    }
+
+    glDeleteSync(readback.fence);
+    readback.fence = nullptr;
+    oldest = (oldest + 1) % READBACKS;
+    inFlight--;
+
+    std::size_t count = (std::size_t) readback.width * readback.height;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    auto* texels = (const GLuint*) glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr) (count * sizeof(GLuint)),
+                                                    GL_MAP_READ_BIT);
+    if(texels)
+    {
+        requests.assign(texels, texels + count);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return texels != nullptr;
+}
+
+float FeedbackBuffer::lodBias() const
+{
+    return -std::log2((float) scale);
+}
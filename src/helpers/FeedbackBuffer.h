@@ -0,0 +1,67 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_FEEDBACKBUFFER_H
+#define LEARNOPENGL_FEEDBACKBUFFER_H
+
+#include <glad/glad.h>
+
+#include <vector>
+
+// small R32UI render target the virtual texture feedback pass draws its page requests into. it's read back
+// through a ring of pixel pack buffers, so the cpu only maps results the gpu finished frames ago and never waits
+class FeedbackBuffer
+{
+public:
+    GLuint framebuffer;
+    int width;
+    int height;
+
+    // a feedback texel per scale x scale screen pixels
+    explicit FeedbackBuffer(int scale = 8);
+    ~FeedbackBuffer();
+
+    FeedbackBuffer(const FeedbackBuffer&) = delete;
+    FeedbackBuffer& operator=(const FeedbackBuffer&) = delete;
+
+    // follows the screen size, binds the framebuffer with its viewport and clears it to no requests.
+    // farDepth is what depth is cleared to, 0 with reverse-Z
+    void begin(int screenWidth, int screenHeight, float farDepth = 1.0f);
+
+    // starts reading back what was drawn since begin(), then rebinds screenFramebuffer and the screen's viewport
+    void end(GLuint screenFramebuffer = 0);
+
+    // the texels of the oldest readback that completed, false if none did yet
+    bool read(std::vector<GLuint>& requests);
+
+    // lod bias that makes the feedback's derivatives match the screen's
+    [[nodiscard]] float lodBias() const;
+
+private:
+    static constexpr int READBACKS = 3;
+
+    struct Readback
+    {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+        int width = 0;
+        int height = 0;
+    };
+
+    int scale;
+    int screenWidth = 0;
+    int screenHeight = 0;
+    GLuint requestBuffer = 0;
+    GLuint depth = 0;
+
+    Readback readbacks[READBACKS];
+    // next readback to write, and the oldest one in flight
+    int next = 0;
+    int oldest = 0;
+    int inFlight = 0;
+
+    void resize(int newWidth, int newHeight);
+};
+
+#endif //LEARNOPENGL_FEEDBACKBUFFER_H
@@ -0,0 +1,189 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "FrustumCuller.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LEARNOPENGL_CULL_SSE
+#endif
+
+#include <bit>
+#include <cmath>
+
+std::uint32_t FrustumCuller::addBox(const glm::vec3& min, const glm::vec3& max)
+{
+    auto index = (std::uint32_t) count++;
+    setBox(index, min, max);
+    return index;
+}
+
+std::uint32_t FrustumCuller::addSphere(const glm::vec3& center, float radius)
+{
+    auto index = (std::uint32_t) count++;
+    setSphere(index, center, radius);
+    return index;
+}
+
+void FrustumCuller::setBox(std::uint32_t index, const glm::vec3& min, const glm::vec3& max)
+{
+    set(index, (min + max) * 0.5f, (max - min) * 0.5f, 0.0f);
+}
+
+void FrustumCuller::setSphere(std::uint32_t index, const glm::vec3& center, float sphereRadius)
+{
+    set(index, center, glm::vec3(0), sphereRadius);
+}
+
+void FrustumCuller::clear()
+{
+    for(std::vector<float>* array : {&centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ, &radius})
+    {
+        array->clear();
+    }
+    count = 0;
+    visible.clear();
+}
+
+std::size_t FrustumCuller::size() const
+{
+    return count;
+}
+
+void FrustumCuller::set(std::uint32_t index, const glm::vec3& center, const glm::vec3& extent, float sphereRadius)
+{
+    // whole batches, so the simd loads never read past the end
+    std::size_t padded = (count + BATCH - 1) / BATCH * BATCH;
+    if(centerX.size() < padded)
+    {
+        for(std::vector<float>* array : {&centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ, &radius})
+        {
+            array->resize(padded, 0.0f);
+        }
+    }
+
+    centerX[index] = center.x;
+    centerY[index] = center.y;
+    centerZ[index] = center.z;
+    extentX[index] = extent.x;
+    extentY[index] = extent.y;
+    extentZ[index] = extent.z;
+    radius[index] = sphereRadius;
+}
+
+const std::vector<std::uint32_t>& FrustumCuller::cull(const Camera::Frustum& frustum)
+{
+    // split once per cull instead of once per batch
+    Planes planes {};
+    for(int p = 0; p < 6; p++)
+    {
+        const glm::vec4& plane = frustum.planes[p];
+        planes.x[p] = plane.x;
+        planes.y[p] = plane.y;
+        planes.z[p] = plane.z;
+        planes.d[p] = plane.w;
+        planes.absX[p] = std::abs(plane.x);
+        planes.absY[p] = std::abs(plane.y);
+        planes.absZ[p] = std::abs(plane.z);
+    }
+
+    visible.clear();
+    visible.reserve(count);
+    for(std::size_t first = 0; first < count; first += BATCH)
+    {
+        unsigned int mask = testBatch(planes, first);
+        // the last batch's padding
+        if(count - first < BATCH)
+        {
+            mask &= (1u << (count - first)) - 1;
+        }
+
+        while(mask != 0)
+        {
+            visible.push_back((std::uint32_t) (first + std::countr_zero(mask)));
+            mask &= mask - 1;
+        }
+    }
+
+    stats.visible = (unsigned int) visible.size();
+    stats.culled = (unsigned int) (count - visible.size());
+    return visible;
+}
+
+// a volume is outside a plane when even its point furthest along the normal is behind it:
+// dot(n, center) + d + dot(abs(n), extent) + radius < 0
+unsigned int FrustumCuller::testBatch(const Planes& planes, std::size_t first) const
+{
+#if defined(__AVX__)
+    const __m256 cx = _mm256_loadu_ps(centerX.data() + first);
+    const __m256 cy = _mm256_loadu_ps(centerY.data() + first);
+    const __m256 cz = _mm256_loadu_ps(centerZ.data() + first);
+    const __m256 ex = _mm256_loadu_ps(extentX.data() + first);
+    const __m256 ey = _mm256_loadu_ps(extentY.data() + first);
+    const __m256 ez = _mm256_loadu_ps(extentZ.data() + first);
+    const __m256 r = _mm256_loadu_ps(radius.data() + first);
+    const __m256 zero = _mm256_setzero_ps();
+
+    __m256 inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+    for(int p = 0; p < 6; p++)
+    {
+        __m256 distance = _mm256_add_ps(_mm256_set1_ps(planes.d[p]), r);
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.x[p]), cx));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.y[p]), cy));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.z[p]), cz));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.absX[p]), ex));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.absY[p]), ey));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.absZ[p]), ez));
+        inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+    }
+    return (unsigned int) _mm256_movemask_ps(inside);
+#elif defined(LEARNOPENGL_CULL_SSE)
+    unsigned int mask = 0;
+    for(std::size_t half = 0; half < BATCH; half += 4)
+    {
+        const std::size_t i = first + half;
+        const __m128 cx = _mm_loadu_ps(centerX.data() + i);
+        const __m128 cy = _mm_loadu_ps(centerY.data() + i);
+        const __m128 cz = _mm_loadu_ps(centerZ.data() + i);
+        const __m128 ex = _mm_loadu_ps(extentX.data() + i);
+        const __m128 ey = _mm_loadu_ps(extentY.data() + i);
+        const __m128 ez = _mm_loadu_ps(extentZ.data() + i);
+        const __m128 r = _mm_loadu_ps(radius.data() + i);
+        const __m128 zero = _mm_setzero_ps();
+
+        __m128 inside = _mm_cmpeq_ps(zero, zero);
+        for(int p = 0; p < 6; p++)
+        {
+            __m128 distance = _mm_add_ps(_mm_set1_ps(planes.d[p]), r);
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.x[p]), cx));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.y[p]), cy));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.z[p]), cz));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.absX[p]), ex));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.absY[p]), ey));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.absZ[p]), ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+        }
+        mask |= (unsigned int) _mm_movemask_ps(inside) << half;
+    }
+    return mask;
+#else
+    unsigned int mask = 0;
+    for(std::size_t lane = 0; lane < BATCH; lane++)
+    {
+        const std::size_t i = first + lane;
+        bool inside = true;
+        for(int p = 0; p < 6; p++)
+        {
+            float distance = planes.d[p] + radius[i] + planes.x[p] * centerX[i] + planes.y[p] * centerY[i]
+                    + planes.z[p] * centerZ[i] + planes.absX[p] * extentX[i] + planes.absY[p] * extentY[i]
+                    + planes.absZ[p] * extentZ[i];
+            inside = inside && distance >= 0.0f;
+        }
+        mask |= (unsigned int) inside << lane;
+    }
+    return mask;
+#endif
+}
@@ -0,0 +1,70 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_FRUSTUMCULLER_H
+#define LEARNOPENGL_FRUSTUMCULLER_H
+
+#include "Camera.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// bounding volumes stored structure of arrays and tested against the frustum 8 at a time: with AVX when the
+// build enables it (LEARNOPENGL_AVX), two SSE halves otherwise, plain loops on other cpus.
+// boxes and spheres share one test, a box has extents and radius 0, a sphere extents 0 and a radius
+class FrustumCuller
+{
+public:
+    struct Stats
+    {
+        unsigned int visible = 0;
+        unsigned int culled = 0;
+    };
+
+    // counts of the last cull
+    Stats stats;
+
+    // world space volumes, the index is what cull() reports
+    std::uint32_t addBox(const glm::vec3& min, const glm::vec3& max);
+    std::uint32_t addSphere(const glm::vec3& center, float radius);
+
+    // moves a volume that's already there
+    void setBox(std::uint32_t index, const glm::vec3& min, const glm::vec3& max);
+    void setSphere(std::uint32_t index, const glm::vec3& center, float radius);
+
+    void clear();
+    [[nodiscard]] std::size_t size() const;
+
+    // indices of the volumes at least partially inside, ascending. valid until the next cull.
+    // conservative: a box near a frustum corner can be kept even though no plane alone rejects it
+    const std::vector<std::uint32_t>& cull(const Camera::Frustum& frustum);
+
+private:
+    static constexpr std::size_t BATCH = 8;
+
+    // padded with zeros to a whole batch, lanes past count are masked off
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> extentX, extentY, extentZ;
+    std::vector<float> radius;
+    std::size_t count = 0;
+
+    std::vector<std::uint32_t> visible;
+
+    // the frustum's planes split into components, with the normals' absolute values for the extents
+    struct Planes
+    {
+        float x[6], y[6], z[6], d[6];
+        float absX[6], absY[6], absZ[6];
+    };
+
+    void set(std::uint32_t index, const glm::vec3& center, const glm::vec3& extent, float sphereRadius);
+
+    // bit i set if volume first + i is inside every plane
+    unsigned int testBatch(const Planes& planes, std::size_t first) const;
+};
+
+#endif //LEARNOPENGL_FRUSTUMCULLER_H
@@ -0,0 +1,85 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "GLExtensions.h"
+
+#include <cstring>
+
+bool GLExtensions::parallelShaderCompile = false;
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC GLExtensions::glMaxShaderCompilerThreadsKHR = nullptr;
+bool GLExtensions::s3tc = false;
+bool GLExtensions::spirv = false;
+PFNGLSPECIALIZESHADERPROC GLExtensions::glSpecializeShaderARB = nullptr;
+bool GLExtensions::bindlessTexture = false;
+PFNGLGETTEXTUREHANDLEARBPROC GLExtensions::glGetTextureHandleARB = nullptr;
+PFNGLGETTEXTURESAMPLERHANDLEARBPROC GLExtensions::glGetTextureSamplerHandleARB = nullptr;
+PFNGLMAKETEXTUREHANDLERESIDENTARBPROC GLExtensions::glMakeTextureHandleResidentARB = nullptr;
+PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC GLExtensions::glMakeTextureHandleNonResidentARB = nullptr;
+bool GLExtensions::sparseTexture = false;
+PFNGLTEXPAGECOMMITMENTARBPROC GLExtensions::glTexPageCommitmentARB = nullptr;
+bool GLExtensions::anisotropicFiltering = false;
+
+bool GLExtensions::has(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+    for(GLint i = 0; i < count; i++)
+    {
+        const char* extension = (const char*) glGetStringi(GL_EXTENSIONS, i);
+        if(extension && std::strcmp(extension, name) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void GLExtensions::load(GLADloadproc loader)
+{
+    // the KHR and ARB versions share the enum and the function signature
+    if(has("GL_KHR_parallel_shader_compile"))
+    {
+        glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC) loader("glMaxShaderCompilerThreadsKHR");
+    }
+    else if(has("GL_ARB_parallel_shader_compile"))
+    {
+        glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC) loader("glMaxShaderCompilerThreadsARB");
+    }
+    parallelShaderCompile = glMaxShaderCompilerThreadsKHR != nullptr;
+
+    s3tc = has("GL_EXT_texture_compression_s3tc");
+
+    // same signature as the core function
+    if(GLAD_GL_VERSION_4_6)
+    {
+        glSpecializeShaderARB = glad_glSpecializeShader;
+    }
+    else if(has("GL_ARB_gl_spirv"))
+    {
+        glSpecializeShaderARB = (PFNGLSPECIALIZESHADERPROC) loader("glSpecializeShaderARB");
+    }
+    spirv = glSpecializeShaderARB != nullptr;
+
+    if(has("GL_ARB_bindless_texture"))
+    {
+        glGetTextureHandleARB = (PFNGLGETTEXTUREHANDLEARBPROC) loader("glGetTextureHandleARB");
+        glGetTextureSamplerHandleARB = (PFNGLGETTEXTURESAMPLERHANDLEARBPROC)
+                loader("glGetTextureSamplerHandleARB");
+        glMakeTextureHandleResidentARB = (PFNGLMAKETEXTUREHANDLERESIDENTARBPROC) loader("glMakeTextureHandleResidentARB");
+        glMakeTextureHandleNonResidentARB = (PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC)
+                loader("glMakeTextureHandleNonResidentARB");
+    }
+    bindlessTexture = glGetTextureHandleARB && glGetTextureSamplerHandleARB && glMakeTextureHandleResidentARB
+            && glMakeTextureHandleNonResidentARB;
+
+    if(has("GL_ARB_sparse_texture"))
+    {
+        glTexPageCommitmentARB = (PFNGLTEXPAGECOMMITMENTARBPROC) loader("glTexPageCommitmentARB");
+    }
+    sparseTexture = glTexPageCommitmentARB != nullptr;
+
+    anisotropicFiltering = GLAD_GL_VERSION_4_6 || has("GL_ARB_texture_filter_anisotropic")
+            || has("GL_EXT_texture_filter_anisotropic");
+}
@@ -0,0 +1,89 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_GLEXTENSIONS_H
+#define LEARNOPENGL_GLEXTENSIONS_H
+
+#include <glad/glad.h>
+
+// glad was generated without extensions, so the few we use are declared and loaded here
+
+// KHR_parallel_shader_compile / ARB_parallel_shader_compile
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+// ARB_gl_spirv, core in 4.6 (glad only loads the core name when the context is 4.6)
+#ifndef GL_SHADER_BINARY_FORMAT_SPIR_V_ARB
+#define GL_SHADER_BINARY_FORMAT_SPIR_V_ARB 0x9551
+#endif
+
+// EXT_texture_compression_s3tc (BC1/BC3) and its EXT_texture_sRGB variants, never made core
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+// ARB_bindless_texture, never made core
+typedef GLuint64 (APIENTRYP PFNGLGETTEXTUREHANDLEARBPROC)(GLuint texture);
+typedef void (APIENTRYP PFNGLMAKETEXTUREHANDLERESIDENTARBPROC)(GLuint64 handle);
+typedef void (APIENTRYP PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC)(GLuint64 handle);
+typedef GLuint64 (APIENTRYP PFNGLGETTEXTURESAMPLERHANDLEARBPROC)(GLuint texture, GLuint sampler);
+
+// ARB_sparse_texture, never made core
+#ifndef GL_TEXTURE_SPARSE_ARB
+#define GL_VIRTUAL_PAGE_SIZE_X_ARB 0x9195
+#define GL_VIRTUAL_PAGE_SIZE_Y_ARB 0x9196
+#define GL_TEXTURE_SPARSE_ARB 0x91A6
+#define GL_VIRTUAL_PAGE_SIZE_INDEX_ARB 0x91A7
+#define GL_NUM_VIRTUAL_PAGE_SIZES_ARB 0x91A8
+#define GL_NUM_SPARSE_LEVELS_ARB 0x91AA
+#endif
+typedef void (APIENTRYP PFNGLTEXPAGECOMMITMENTARBPROC)(GLenum target, GLint level, GLint xoffset, GLint yoffset,
+                                                       GLint zoffset, GLsizei width, GLsizei height, GLsizei depth,
+                                                       GLboolean commit);
+
+class GLExtensions
+{
+public:
+    // call once after gladLoadGLLoader with the same loader
+    static void load(GLADloadproc loader);
+
+    // searches the context's extension list
+    [[nodiscard]] static bool has(const char* name);
+
+    // GL_COMPLETION_STATUS_KHR can be polled instead of blocking on compile/link status
+    static bool parallelShaderCompile;
+    static PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR;
+
+    // BC1/BC3 textures can be uploaded. BC5 (RGTC) and BC7 (BPTC) are core
+    static bool s3tc;
+
+    // SPIR-V modules can be loaded with glShaderBinary and specialized with glSpecializeShaderARB
+    static bool spirv;
+    static PFNGLSPECIALIZESHADERPROC glSpecializeShaderARB;
+
+    // textures can be sampled through 64-bit handles instead of texture units, see BindlessTextures
+    static bool bindlessTexture;
+    static PFNGLGETTEXTUREHANDLEARBPROC glGetTextureHandleARB;
+    static PFNGLGETTEXTURESAMPLERHANDLEARBPROC glGetTextureSamplerHandleARB;
+    static PFNGLMAKETEXTUREHANDLERESIDENTARBPROC glMakeTextureHandleResidentARB;
+    static PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC glMakeTextureHandleNonResidentARB;
+
+    // textures can be allocated without memory and have it committed page by page, see VirtualTexture
+    static bool sparseTexture;
+    static PFNGLTEXPAGECOMMITMENTARBPROC glTexPageCommitmentARB;
+
+    // GL_TEXTURE_MAX_ANISOTROPY can be set on samplers, core in 4.6 and the same enum in the ARB/EXT versions
+    static bool anisotropicFiltering;
+};
+
+#endif //LEARNOPENGL_GLEXTENSIONS_H
@@ -0,0 +1,248 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "GLState.h"
+
+GLState::Stats GLState::frameStats {};
+
+GLuint GLState::program = UNKNOWN;
+GLuint GLState::programPipeline = UNKNOWN;
+GLuint GLState::vertexArray = UNKNOWN;
+GLuint GLState::activeUnit = UNKNOWN;
+GLuint GLState::textures[MAX_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+GLuint GLState::samplers[MAX_TEXTURE_UNITS];
+int GLState::capabilities[CAPABILITY_COUNT] = {-1, -1, -1};
+
+// static storage starts zeroed, which would read as "texture 0 bound"
+[[maybe_unused]] static const bool texturesUnknown = []
+{
+    GLState::invalidate();
+    return true;
+}();
+
+bool GLState::change(GLuint& current, GLuint value)
+{
+    if(current == value)
+    {
+        frameStats.elided++;
+        return false;
+    }
+
+    current = value;
+    frameStats.issued++;
+    return true;
+}
+
+int GLState::textureTargetIndex(GLenum target)
+{
+    for(int i = 0; i < TEXTURE_TARGET_COUNT; i++)
+    {
+        if(TEXTURE_TARGETS[i] == target)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int GLState::capabilityIndex(GLenum capability)
+{
+    for(int i = 0; i < CAPABILITY_COUNT; i++)
+    {
+        if(CAPABILITIES[i] == capability)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void GLState::useProgram(GLuint newProgram)
+{
+    if(change(program, newProgram))
+    {
+        glUseProgram(newProgram);
+    }
+}
+
+void GLState::bindProgramPipeline(GLuint pipeline)
+{
+    useProgram(0);
+    if(change(programPipeline, pipeline))
+    {
+        glBindProgramPipeline(pipeline);
+    }
+}
+
+void GLState::bindVertexArray(GLuint vao)
+{
+    if(change(vertexArray, vao))
+    {
+        glBindVertexArray(vao);
+    }
+}
+
+void GLState::activeTexture(GLuint unit)
+{
+    if(change(activeUnit, unit))
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+}
+
+void GLState::bindTexture(GLenum target, GLuint texture)
+{
+    int targetIndex = textureTargetIndex(target);
+
+    // untracked target or unit, always send it
+    if(targetIndex == -1 || activeUnit >= MAX_TEXTURE_UNITS)
+    {
+        frameStats.issued++;
+        glBindTexture(target, texture);
+        return;
+    }
+
+    if(change(textures[activeUnit][targetIndex], texture))
+    {
+        glBindTexture(target, texture);
+    }
+}
+
+void GLState::bindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+    int targetIndex = textureTargetIndex(target);
+    if(targetIndex != -1 && unit < MAX_TEXTURE_UNITS && textures[unit][targetIndex] == texture)
+    {
+        frameStats.elided++;
+        return;
+    }
+
+    activeTexture(unit);
+    bindTexture(target, texture);
+}
+
+void GLState::bindSampler(GLuint unit, GLuint sampler)
+{
+    if(unit >= MAX_TEXTURE_UNITS)
+    {
+        frameStats.issued++;
+        glBindSampler(unit, sampler);
+        return;
+    }
+
+    if(change(samplers[unit], sampler))
+    {
+        glBindSampler(unit, sampler);
+    }
+}
+
+void GLState::setCapability(GLenum capability, bool enabled)
+{
+    int index = capabilityIndex(capability);
+    if(index != -1 && capabilities[index] == (int) enabled)
+    {
+        frameStats.elided++;
+        return;
+    }
+
+    if(index != -1)
+    {
+        capabilities[index] = enabled;
+    }
+    frameStats.issued++;
+
+    if(enabled)
+    {
+        glEnable(capability);
+    }
+    else
+    {
+        glDisable(capability);
+    }
+}
+
+void GLState::enable(GLenum capability)
+{
+    setCapability(capability, true);
+}
+
+void GLState::disable(GLenum capability)
+{
+    setCapability(capability, false);
+}
+
+void GLState::forgetProgram(GLuint deleted)
+{
+    if(program == deleted)
+    {
+        program = UNKNOWN;
+    }
+}
+
+void GLState::forgetProgramPipeline(GLuint deleted)
+{
+    if(programPipeline == deleted)
+    {
+        programPipeline = UNKNOWN;
+    }
+}
+
+void GLState::forgetVertexArray(GLuint deleted)
+{
+    if(vertexArray == deleted)
+    {
+        vertexArray = UNKNOWN;
+    }
+}
+
+void GLState::forgetTexture(GLuint deleted)
+{
+    for(auto& unit : textures)
+    {
+        for(GLuint& texture : unit)
+        {
+            if(texture == deleted)
+            {
+                texture = UNKNOWN;
+            }
+        }
+    }
+}
+
+void GLState::forgetSampler(GLuint deleted)
+{
+    for(GLuint& sampler : samplers)
+    {
+        if(sampler == deleted)
+        {
+            sampler = UNKNOWN;
+        }
+    }
+}
+
+void GLState::invalidate()
+{
+    program = UNKNOWN;
+    programPipeline = UNKNOWN;
+    vertexArray = UNKNOWN;
+    activeUnit = UNKNOWN;
+
+    for(auto& unit : textures)
+    {
+        for(GLuint& texture : unit)
+        {
+            texture = UNKNOWN;
+        }
+    }
+
+    for(GLuint& sampler : samplers)
+    {
+        sampler = UNKNOWN;
+    }
+
+    for(int& capability : capabilities)
+    {
+        capability = -1;
+    }
+}
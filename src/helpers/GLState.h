@@ -0,0 +1,84 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_GLSTATE_H
+#define LEARNOPENGL_GLSTATE_H
+
+#include <glad/glad.h>
+
+// mirror of the bind/enable state the helpers change, so calls that wouldn't change anything are skipped.
+// everything that binds programs, VAOs, textures or samplers, or toggles capabilities, should go through here
+class GLState
+{
+public:
+    struct Stats
+    {
+        unsigned int issued = 0;
+        unsigned int elided = 0;
+    };
+
+    // state changes sent to/skipped since the last reset, main resets it every frame
+    static Stats frameStats;
+
+    static constexpr GLuint MAX_TEXTURE_UNITS = 32;
+
+    static void useProgram(GLuint program);
+
+    // a bound program overrides the pipeline, so this also unbinds the program
+    static void bindProgramPipeline(GLuint pipeline);
+    static void bindVertexArray(GLuint vao);
+
+    static void activeTexture(GLuint unit);
+
+    // binds to the active unit
+    static void bindTexture(GLenum target, GLuint texture);
+    // switches the active unit only if the binding actually changes
+    static void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+    // sampler objects are bound by unit, no need to switch the active one
+    static void bindSampler(GLuint unit, GLuint sampler);
+
+    static void enable(GLenum capability);
+    static void disable(GLenum capability);
+
+    // deleted names can be handed out again, so they must not count as bound anymore
+    static void forgetProgram(GLuint program);
+    static void forgetProgramPipeline(GLuint pipeline);
+    static void forgetVertexArray(GLuint vao);
+    static void forgetTexture(GLuint texture);
+    static void forgetSampler(GLuint sampler);
+
+    // forget everything, for code that changed state without going through here
+    static void invalidate();
+
+private:
+    // the texture targets we track per unit
+    static constexpr GLenum TEXTURE_TARGETS[] = {GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_CUBE_MAP};
+    static constexpr int TEXTURE_TARGET_COUNT = sizeof(TEXTURE_TARGETS) / sizeof(TEXTURE_TARGETS[0]);
+
+    static constexpr GLenum CAPABILITIES[] = {GL_DEPTH_TEST, GL_BLEND, GL_CULL_FACE};
+    static constexpr int CAPABILITY_COUNT = sizeof(CAPABILITIES) / sizeof(CAPABILITIES[0]);
+
+    // bound names, UNKNOWN until the first call so it always goes through
+    static constexpr GLuint UNKNOWN = 0xFFFFFFFF;
+
+    static GLuint program;
+    static GLuint programPipeline;
+    static GLuint vertexArray;
+    static GLuint activeUnit;
+    static GLuint textures[MAX_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+    static GLuint samplers[MAX_TEXTURE_UNITS];
+
+    // -1 unknown, 0 disabled, 1 enabled
+    static int capabilities[CAPABILITY_COUNT];
+
+    static int textureTargetIndex(GLenum target);
+    static int capabilityIndex(GLenum capability);
+    static void setCapability(GLenum capability, bool enabled);
+
+    // returns true (and counts it) when current != value, then updates current
+    static bool change(GLuint& current, GLuint value);
+};
+
+#endif //LEARNOPENGL_GLSTATE_H
@@ -0,0 +1,44 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_HASH_H
+#define LEARNOPENGL_HASH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+// FNV-1a, small and constexpr so names can be hashed at compile time
+constexpr std::uint32_t fnv1a32(const char* data, std::size_t length, std::uint32_t hash = 2166136261u)
+{
+    for(std::size_t i = 0; i < length; i++)
+    {
+        hash ^= (std::uint8_t) data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+constexpr std::uint32_t fnv1a32(std::string_view str)
+{
+    return fnv1a32(str.data(), str.size());
+}
+
+// 64 bit variant for content keys (caches), where collisions would be expensive
+constexpr std::uint64_t fnv1a64(const char* data, std::size_t length, std::uint64_t hash = 14695981039346656037ull)
+{
+    for(std::size_t i = 0; i < length; i++)
+    {
+        hash ^= (std::uint8_t) data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+constexpr std::uint64_t fnv1a64(std::string_view str, std::uint64_t hash = 14695981039346656037ull)
+{
+    return fnv1a64(str.data(), str.size(), hash);
+}
+
+#endif //LEARNOPENGL_HASH_H
@@ -0,0 +1,94 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "IndirectDraws.h"
+#include "GLState.h"
+
+#include <iostream>
+
+IndirectDraws::IndirectDraws(const std::vector<DrawObject>& objects, int materialCount, GLsizei vertexCount,
+                             GLint first)
+        : objectBuffer(0), visibleBuffer(0), commandBuffer(0), objectCount((GLuint) objects.size())
+{
+    commands.resize((std::size_t) materialCount, {(GLuint) vertexCount, 0, (GLuint) first, 0});
+    for(const DrawObject& object : objects)
+    {
+        if(object.material >= commands.size())
+        {
+            std::cout << "ERROR::INDIRECT_DRAWS::MATERIAL_OUT_OF_RANGE material " << object.material
+                      << " of " << materialCount << "\n";
+            objectCount = 0;
+            return;
+        }
+        commands[object.material].instanceCount++;
+    }
+
+    // a material's visible objects can't outnumber its objects, so each gets that many slots
+    GLuint offset = 0;
+    for(Command& command : commands)
+    {
+        command.baseInstance = offset;
+        offset += command.instanceCount;
+        command.instanceCount = 0;
+    }
+
+    GLuint buffers[3];
+    glGenBuffers(3, buffers);
+    objectBuffer = buffers[0];
+    visibleBuffer = buffers[1];
+    commandBuffer = buffers[2];
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, objectBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr) (objects.size() * sizeof(DrawObject)), objects.data(),
+                 GL_STATIC_DRAW);
+    // only ever written and read by the gpu
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibleBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr) (objects.size() * sizeof(GLuint)), nullptr, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr) (commands.size() * sizeof(Command)), commands.data(),
+                 GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+IndirectDraws::~IndirectDraws()
+{
+    GLuint buffers[3] = {objectBuffer, visibleBuffer, commandBuffer};
+    glDeleteBuffers(3, buffers);
+}
+
+void IndirectDraws::cull(GLuint cullProgram) const
+{
+    if(objectCount == 0)
+    {
+        return;
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, OBJECTS_BINDING, objectBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBLE_BINDING, visibleBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMANDS_BINDING, commandBuffer);
+
+    // the last frame's draws are ordered before this by the gl, no fence needed
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, (GLsizeiptr) (commands.size() * sizeof(Command)), commands.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    GLState::useProgram(cullProgram);
+    glDispatchCompute((objectCount + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+
+    // the commands are read as indirect arguments, the visible list from the vertex shader
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void IndirectDraws::draw() const
+{
+    if(objectCount == 0)
+    {
+        return;
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    // empty commands draw nothing, so there's no need for the count to come from the gpu too
+    glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, (GLsizei) commands.size(), 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
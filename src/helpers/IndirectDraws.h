@@ -0,0 +1,75 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_INDIRECTDRAWS_H
+#define LEARNOPENGL_INDIRECTDRAWS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// std430 mirror of draw_objects.glsl's DrawObject
+struct DrawObject
+{
+    glm::mat4 model;
+    // transpose of the inverse of model, widened to a mat4 so its columns line up with std430
+    glm::mat4 normalMat;
+    // world space center and radius
+    glm::vec4 boundingSphere;
+    GLuint material;
+    GLuint _pad[3];
+};
+
+static_assert(sizeof(DrawObject) == 160, "DrawObject has to match its std430 layout");
+
+// objects that share a mesh, drawn without the cpu touching them per frame. everything is uploaded once,
+// then cull_objects.comp tests each one against FrameData's frustum planes and lists the visible ones
+// under their material's draw command, and one multi draw indirect draws every material.
+// the cpu cost per frame is the same for any number of objects
+class IndirectDraws
+{
+public:
+    // shader storage bindings, as declared in draw_objects.glsl and cull_objects.comp
+    static constexpr GLuint OBJECTS_BINDING = 0;
+    static constexpr GLuint VISIBLE_BINDING = 1;
+    static constexpr GLuint COMMANDS_BINDING = 2;
+
+    // the compute shader's local size
+    static constexpr GLuint GROUP_SIZE = 64;
+
+    GLuint objectBuffer;
+    GLuint visibleBuffer;
+    GLuint commandBuffer;
+
+    // materials are 0..materialCount-1, each gets a command of vertexCount vertices from first
+    IndirectDraws(const std::vector<DrawObject>& objects, int materialCount, GLsizei vertexCount, GLint first = 0);
+    ~IndirectDraws();
+
+    IndirectDraws(const IndirectDraws&) = delete;
+    IndirectDraws& operator=(const IndirectDraws&) = delete;
+
+    // empties the commands and dispatches cullProgram over every object. FrameData has to be up to date
+    void cull(GLuint cullProgram) const;
+
+    // the objects the last cull kept, with the bound pipeline and vao. the vertex stage reads its object
+    // with gl_BaseInstance + gl_InstanceID, and gl_DrawID is the material
+    void draw() const;
+
+private:
+    // DrawArraysIndirectCommand
+    struct Command
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint first;
+        GLuint baseInstance;
+    };
+
+    // uploaded before every cull: instanceCount 0, baseInstance where the material's slots start
+    std::vector<Command> commands;
+    GLuint objectCount;
+};
+
+#endif //LEARNOPENGL_INDIRECTDRAWS_H
@@ -0,0 +1,60 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "InstanceBuffer.h"
+#include "GLState.h"
+
+#include <algorithm>
+#include <cstddef>
+
+InstanceBuffer::InstanceBuffer()
+{
+    glGenBuffers(1, &ID);
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+    glDeleteBuffers(1, &ID);
+}
+
+void InstanceBuffer::attach(GLuint vao, GLuint firstLocation) const
+{
+    GLState::bindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, ID);
+
+    // matrices take a location per column
+    for(GLuint column = 0; column < 4; column++)
+    {
+        GLuint location = firstLocation + column;
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*) (offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+    for(GLuint column = 0; column < 3; column++)
+    {
+        GLuint location = firstLocation + 4 + column;
+        glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*) (offsetof(InstanceData, normalMat) + column * sizeof(glm::vec3)));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::update(const std::vector<InstanceData>& instances)
+{
+    if(instances.empty())
+    {
+        return;
+    }
+
+    capacity = std::max(capacity, instances.size());
+
+    glBindBuffer(GL_ARRAY_BUFFER, ID);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) (capacity * sizeof(InstanceData)), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr) (instances.size() * sizeof(InstanceData)), instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
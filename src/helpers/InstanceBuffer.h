@@ -0,0 +1,44 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_INSTANCEBUFFER_H
+#define LEARNOPENGL_INSTANCEBUFFER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// what an instanced draw reads per instance (transform.glsl's instanceModel and instanceNormalMat)
+struct InstanceData
+{
+    glm::mat4 model;
+    // transpose of the inverse of model, computed once on the cpu instead of per vertex
+    glm::mat3 normalMat;
+};
+
+// vertex buffer of InstanceData, fed to the vertex shader with a divisor of 1 so a single instanced draw
+// covers every object sharing a mesh
+class InstanceBuffer
+{
+public:
+    GLuint ID;
+
+    InstanceBuffer();
+    ~InstanceBuffer();
+
+    InstanceBuffer(const InstanceBuffer&) = delete;
+    InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+    // points attributes firstLocation..+3 (model columns) and +4..+6 (normal matrix columns) of vao at the buffer
+    void attach(GLuint vao, GLuint firstLocation = 3) const;
+
+    // replaces the contents, the old storage is orphaned so draws still reading it don't stall the upload
+    void update(const std::vector<InstanceData>& instances);
+
+private:
+    std::size_t capacity = 0;
+};
+
+#endif //LEARNOPENGL_INSTANCEBUFFER_H
@@ -0,0 +1,165 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "ProgramBinaryCache.h"
+#include "Hash.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+std::string ProgramBinaryCache::directory = "../shader_cache/";
+
+// identifies our files, bumped when the layout changes
+static const std::uint32_t CACHE_MAGIC = 0x4c4f4231; // "LOB1"
+
+struct CacheHeader
+{
+    std::uint32_t magic;
+    GLenum format;
+    GLint length;
+};
+
+std::uint64_t ProgramBinaryCache::key(const std::vector<std::string_view>& parts)
+{
+    std::uint64_t hash = fnv1a64("");
+    for(std::string_view part : parts)
+    {
+        hash = fnv1a64(part, hash);
+        // separator so moving text between parts changes the key
+        hash = fnv1a64("\0", 1, hash);
+    }
+
+    for(GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+    {
+        const char* value = (const char*) glGetString(name);
+        hash = fnv1a64(value ? value : "", hash);
+    }
+
+    return hash;
+}
+
+bool ProgramBinaryCache::supported()
+{
+    static const bool hasFormats = []
+    {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }();
+    return hasFormats;
+}
+
+std::string ProgramBinaryCache::pathFor(std::uint64_t key)
+{
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", (unsigned long long) key);
+    return directory + name + ".bin";
+}
+
+bool ProgramBinaryCache::load(GLuint program, std::uint64_t key)
+{
+    if(!supported())
+    {
+        return false;
+    }
+
+    std::string path = pathFor(key);
+    std::ifstream file(path, std::ios::binary);
+    if(!file)
+    {
+        return false;
+    }
+
+    // entries that can't be removed (read-only, locked) are just not used
+    std::error_code error;
+    const std::uintmax_t fileSize = std::filesystem::file_size(path, error);
+
+    CacheHeader header {};
+    file.read((char*) &header, sizeof(header));
+    if(!file || error || header.magic != CACHE_MAGIC || header.length <= 0
+            || (std::uintmax_t) header.length > fileSize - sizeof(header))
+    {
+        std::cout << "shader cache entry " << path << " is corrupt\n";
+        file.close();
+        std::filesystem::remove(path, error);
+        return false;
+    }
+
+    std::vector<char> binary(header.length);
+    file.read(binary.data(), header.length);
+    if(!file)
+    {
+        std::cout << "shader cache entry " << path << " is truncated\n";
+        file.close();
+        std::filesystem::remove(path, error);
+        return false;
+    }
+    file.close();
+
+    glProgramBinary(program, header.format, binary.data(), header.length);
+
+    // drivers may reject binaries at any time (e.g. after an update), we then compile from source
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if(!success)
+    {
+        std::cout << "shader cache entry " << path << " was rejected by the driver\n";
+        std::filesystem::remove(path, error);
+        return false;
+    }
+
+    return true;
+}
+
+void ProgramBinaryCache::store(GLuint program, std::uint64_t key)
+{
+    if(!supported())
+    {
+        return;
+    }
+
+    GLint linked;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if(!linked)
+    {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if(length <= 0)
+    {
+        return;
+    }
+
+    CacheHeader header {CACHE_MAGIC, 0, length};
+    std::vector<char> binary(length);
+    glGetProgramBinary(program, length, nullptr, &header.format, binary.data());
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    // write to a temporary and rename so a crash never leaves a half written entry
+    std::string path = pathFor(key);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if(!file)
+        {
+            std::cout << "could not write shader cache entry " << path << '\n';
+            return;
+        }
+        file.write((const char*) &header, sizeof(header));
+        file.write(binary.data(), length);
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if(error)
+    {
+        std::filesystem::remove(tempPath, error);
+    }
+}
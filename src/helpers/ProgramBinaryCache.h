@@ -0,0 +1,39 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_PROGRAMBINARYCACHE_H
+#define LEARNOPENGL_PROGRAMBINARYCACHE_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// stores linked programs on disk (glGetProgramBinary) so later launches can skip compiling
+class ProgramBinaryCache
+{
+public:
+    // relative to the working directory, like the shader and texture paths
+    static std::string directory;
+
+    // hash of the sources (and anything else that changes the binary) and the driver strings,
+    // a driver update invalidates every entry
+    static std::uint64_t key(const std::vector<std::string_view>& parts);
+
+    // loads the cached binary into program, false if there is none or the driver rejected it
+    static bool load(GLuint program, std::uint64_t key);
+
+    // writes program's binary, program must be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+    static void store(GLuint program, std::uint64_t key);
+
+    // false when the driver exposes no binary formats, load and store do nothing then
+    static bool supported();
+
+private:
+    static std::string pathFor(std::uint64_t key);
+};
+
+#endif //LEARNOPENGL_PROGRAMBINARYCACHE_H
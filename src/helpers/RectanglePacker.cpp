@@ -0,0 +1,71 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "RectanglePacker.h"
+
+#include <algorithm>
+#include <numeric>
+
+RectanglePacker::RectanglePacker(int pageWidth, int pageHeight) : pageWidth(pageWidth), pageHeight(pageHeight)
+{
+}
+
+bool RectanglePacker::pack(std::vector<Rectangle>& rectangles)
+{
+    // tallest first keeps the space wasted above short rectangles small
+    std::vector<std::size_t> order(rectangles.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&rectangles](std::size_t a, std::size_t b)
+    {
+        return rectangles[a].height > rectangles[b].height;
+    });
+
+    std::vector<Shelf> shelves;
+    // y where the next shelf of each page starts
+    std::vector<int> pageBottoms;
+    bool packed = true;
+
+    for(std::size_t index : order)
+    {
+        Rectangle& rectangle = rectangles[index];
+        rectangle.page = -1;
+
+        if(rectangle.width > pageWidth || rectangle.height > pageHeight)
+        {
+            packed = false;
+            continue;
+        }
+
+        auto shelf = std::find_if(shelves.begin(), shelves.end(), [this, &rectangle](const Shelf& s)
+        {
+            return s.x + rectangle.width <= pageWidth && rectangle.height <= s.height;
+        });
+
+        if(shelf == shelves.end())
+        {
+            // new shelf on the first page with room left, or on a new page
+            auto page = std::find_if(pageBottoms.begin(), pageBottoms.end(), [this, &rectangle](int bottom)
+            {
+                return bottom + rectangle.height <= pageHeight;
+            });
+            if(page == pageBottoms.end())
+            {
+                pageBottoms.push_back(0);
+                page = pageBottoms.end() - 1;
+            }
+
+            shelves.push_back({(int) (page - pageBottoms.begin()), *page, rectangle.height, 0});
+            *page += rectangle.height;
+            shelf = shelves.end() - 1;
+        }
+
+        rectangle.x = shelf->x;
+        rectangle.y = shelf->y;
+        rectangle.page = shelf->page;
+        shelf->x += rectangle.width;
+    }
+
+    pages = (int) pageBottoms.size();
+    return packed;
+}
@@ -0,0 +1,48 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_RECTANGLEPACKER_H
+#define LEARNOPENGL_RECTANGLEPACKER_H
+
+#include <vector>
+
+// shelf packer: rectangles go tallest first into rows ("shelves") of pages of a fixed size,
+// a new page is started when none of the open ones has room
+class RectanglePacker
+{
+public:
+    struct Rectangle
+    {
+        int width;
+        int height;
+
+        // filled in by pack()
+        int x = 0;
+        int y = 0;
+        int page = -1;
+    };
+
+    RectanglePacker(int pageWidth, int pageHeight);
+
+    // places every rectangle, false if one is bigger than a page (its page stays -1)
+    bool pack(std::vector<Rectangle>& rectangles);
+
+    // pages used by the last pack()
+    int pages = 0;
+
+private:
+    struct Shelf
+    {
+        int page;
+        int y;
+        int height;
+        // next free x
+        int x;
+    };
+
+    int pageWidth;
+    int pageHeight;
+};
+
+#endif //LEARNOPENGL_RECTANGLEPACKER_H
@@ -0,0 +1,251 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "ResourceManager.h"
+#include "Hash.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+ResourceManager::TextureHandle::TextureHandle(ResourceManager* owner, std::uint32_t index, std::uint32_t generation)
+        : owner(owner), index(index), generation(generation)
+{
+    owner->addReference(index, generation);
+}
+
+ResourceManager::TextureHandle::~TextureHandle()
+{
+    reset();
+}
+
+ResourceManager::TextureHandle::TextureHandle(const TextureHandle& other)
+        : owner(other.owner), index(other.index), generation(other.generation)
+{
+    if(owner)
+    {
+        owner->addReference(index, generation);
+    }
+}
+
+ResourceManager::TextureHandle& ResourceManager::TextureHandle::operator=(const TextureHandle& other)
+{
+    if(this != &other)
+    {
+        // the new reference first, other may be the last one keeping the same texture alive through this
+        if(other.owner)
+        {
+            other.owner->addReference(other.index, other.generation);
+        }
+        reset();
+        owner = other.owner;
+        index = other.index;
+        generation = other.generation;
+    }
+    return *this;
+}
+
+ResourceManager::TextureHandle::TextureHandle(TextureHandle&& other) noexcept
+        : owner(other.owner), index(other.index), generation(other.generation)
+{
+    other.owner = nullptr;
+}
+
+ResourceManager::TextureHandle& ResourceManager::TextureHandle::operator=(TextureHandle&& other) noexcept
+{
+    if(this != &other)
+    {
+        reset();
+        owner = other.owner;
+        index = other.index;
+        generation = other.generation;
+        other.owner = nullptr;
+    }
+    return *this;
+}
+
+const Texture2D* ResourceManager::TextureHandle::get() const
+{
+    if(!owner)
+    {
+        return nullptr;
+    }
+
+    Slot* slot = owner->find(index, generation);
+    return slot ? &slot->texture : nullptr;
+}
+
+void ResourceManager::TextureHandle::reset()
+{
+    if(owner)
+    {
+        owner->removeReference(index, generation);
+        owner = nullptr;
+    }
+}
+
+ResourceManager::~ResourceManager()
+{
+    clear();
+}
+
+ResourceManager::TextureHandle ResourceManager::loadTexture(const std::string& path, bool generateMipMaps)
+{
+    // relative and absolute spellings of the same file are the same key
+    std::error_code error;
+    std::string key = std::filesystem::weakly_canonical(path, error).string();
+    if(error)
+    {
+        key = path;
+    }
+
+    auto named = byPath.find(key);
+    if(named != byPath.end())
+    {
+        stats.deduplicated++;
+        return share(named->second);
+    }
+
+    // a copy under another name is only found by its bytes
+    std::vector<unsigned char> bytes;
+    if(!readFile(path, bytes))
+    {
+        std::cout << "texture " << path << " did not load correctly!\n";
+        return {};
+    }
+
+    std::uint64_t contentHash = fnv1a64((const char*) bytes.data(), bytes.size());
+    auto same = byContent.find(contentHash);
+    if(same != byContent.end())
+    {
+        stats.deduplicated++;
+        slots[same->second].paths.push_back(key);
+        byPath.emplace(key, same->second);
+        return share(same->second);
+    }
+
+    // decoded from the bytes that were hashed, the file is only read once. nothing is registered for a file
+    // that didn't decode, the next load of it tries again
+    Texture2D texture(path, std::move(bytes), generateMipMaps);
+    if(texture.ID == 0)
+    {
+        return {};
+    }
+
+    std::uint32_t index;
+    if(freeSlots.empty())
+    {
+        index = (std::uint32_t) slots.size();
+        slots.emplace_back();
+    }
+    else
+    {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+
+    Slot& slot = slots[index];
+    slot.texture = std::move(texture);
+    slot.contentHash = contentHash;
+    slot.paths = {key};
+    byPath.emplace(key, index);
+    byContent.emplace(contentHash, index);
+
+    stats.loads++;
+    stats.live++;
+    return share(index);
+}
+
+void ResourceManager::endFrame()
+{
+    frames.push_back({frame, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)});
+    frame++;
+
+    // fences signal in order, stop at the first frame still in flight
+    bool anyCompleted = false;
+    std::uint64_t completed = 0;
+    while(!frames.empty() && glClientWaitSync(frames.front().fence, 0, 0) != GL_TIMEOUT_EXPIRED)
+    {
+        completed = frames.front().frame;
+        anyCompleted = true;
+        glDeleteSync(frames.front().fence);
+        frames.pop_front();
+    }
+
+    while(anyCompleted && !retired.empty() && retired.front().frame <= completed)
+    {
+        retired.pop_front();
+        stats.retired--;
+    }
+}
+
+void ResourceManager::clear()
+{
+    for(Frame& inFlight : frames)
+    {
+        glDeleteSync(inFlight.fence);
+    }
+    frames.clear();
+    retired.clear();
+    stats.retired = 0;
+}
+
+ResourceManager::Slot* ResourceManager::find(std::uint32_t index, std::uint32_t generation)
+{
+    if(index >= slots.size() || slots[index].generation != generation || slots[index].references == 0)
+    {
+        return nullptr;
+    }
+    return &slots[index];
+}
+
+ResourceManager::TextureHandle ResourceManager::share(std::uint32_t index)
+{
+    return {this, index, slots[index].generation};
+}
+
+void ResourceManager::addReference(std::uint32_t index, std::uint32_t generation)
+{
+    if(index < slots.size() && slots[index].generation == generation)
+    {
+        slots[index].references++;
+    }
+}
+
+void ResourceManager::removeReference(std::uint32_t index, std::uint32_t generation)
+{
+    Slot* slot = find(index, generation);
+    if(!slot || --slot->references > 0)
+    {
+        return;
+    }
+
+    // draws recorded this frame may still sample it, endFrame deletes it once they're done
+    for(const std::string& path : slot->paths)
+    {
+        byPath.erase(path);
+    }
+    byContent.erase(slot->contentHash);
+    slot->paths.clear();
+
+    retired.push_back({std::move(slot->texture), frame});
+    slot->generation++;
+    freeSlots.push_back(index);
+
+    stats.live--;
+    stats.retired++;
+}
+
+bool ResourceManager::readFile(const std::string& path, std::vector<unsigned char>& bytes)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file)
+    {
+        return false;
+    }
+
+    bytes.assign(std::istreambuf_iterator<char>(file), {});
+    return true;
+}
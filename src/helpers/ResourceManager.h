@@ -0,0 +1,132 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_RESOURCEMANAGER_H
+#define LEARNOPENGL_RESOURCEMANAGER_H
+
+#include "Texture2D.h"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// owns textures loaded from files and hands out ref-counted handles to them. loads are deduplicated by path
+// and by a hash of the file's bytes, so the same image under two names is one texture object. when the last
+// handle goes away the texture is retired, and deleted once the gpu finished the frame it was retired in.
+// slots are reused, their generation tells handles to a texture that's gone from handles to its replacement
+class ResourceManager
+{
+public:
+    class TextureHandle
+    {
+    public:
+        TextureHandle() = default;
+        ~TextureHandle();
+
+        // copies share the texture, the count goes up
+        TextureHandle(const TextureHandle& other);
+        TextureHandle& operator=(const TextureHandle& other);
+        TextureHandle(TextureHandle&& other) noexcept;
+        TextureHandle& operator=(TextureHandle&& other) noexcept;
+
+        // nullptr for empty or stale handles. valid until the next load
+        [[nodiscard]] const Texture2D* get() const;
+        const Texture2D* operator->() const { return get(); }
+        explicit operator bool() const { return get() != nullptr; }
+
+        bool operator==(const TextureHandle& other) const
+        {
+            return owner == other.owner && index == other.index && generation == other.generation;
+        }
+
+    private:
+        friend class ResourceManager;
+
+        ResourceManager* owner = nullptr;
+        std::uint32_t index = 0;
+        std::uint32_t generation = 0;
+
+        TextureHandle(ResourceManager* owner, std::uint32_t index, std::uint32_t generation);
+        void reset();
+    };
+
+    struct Stats
+    {
+        // distinct textures loaded, and loads that were answered with one of them
+        unsigned int loads = 0;
+        unsigned int deduplicated = 0;
+
+        unsigned int live = 0;
+        // released but possibly still used by a frame in flight
+        unsigned int retired = 0;
+    };
+
+    Stats stats;
+
+    ResourceManager() = default;
+    // handles must be gone by now, retired textures are deleted right away so the context must be current
+    ~ResourceManager();
+
+    // handles point back at the manager
+    ResourceManager(const ResourceManager&) = delete;
+    ResourceManager& operator=(const ResourceManager&) = delete;
+
+    // empty handle (with a message) if the file can't be read or decoded
+    TextureHandle loadTexture(const std::string& path, bool generateMipMaps = true);
+
+    // fences the frame's commands and deletes the textures retired in frames the gpu is done with.
+    // call once per frame, after the last draw
+    void endFrame();
+
+    // deletes every retired texture without waiting, for shutdown once the handles are gone
+    void clear();
+
+private:
+    struct Slot
+    {
+        Texture2D texture;
+        std::uint32_t generation = 0;
+        std::uint32_t references = 0;
+        std::uint64_t contentHash = 0;
+        // every path the texture was asked for by, so they stop resolving to it once it's retired
+        std::vector<std::string> paths;
+    };
+
+    struct Retired
+    {
+        Texture2D texture;
+        std::uint64_t frame;
+    };
+
+    struct Frame
+    {
+        std::uint64_t frame;
+        GLsync fence;
+    };
+
+    // a deque so slots don't move when new ones are added
+    std::deque<Slot> slots;
+    std::vector<std::uint32_t> freeSlots;
+
+    std::unordered_map<std::string, std::uint32_t> byPath;
+    std::unordered_map<std::uint64_t, std::uint32_t> byContent;
+
+    std::deque<Retired> retired;
+    std::deque<Frame> frames;
+    std::uint64_t frame = 0;
+
+    Slot* find(std::uint32_t index, std::uint32_t generation);
+    TextureHandle share(std::uint32_t index);
+
+    void addReference(std::uint32_t index, std::uint32_t generation);
+    void removeReference(std::uint32_t index, std::uint32_t generation);
+
+    static bool readFile(const std::string& path, std::vector<unsigned char>& bytes);
+};
+
+#endif //LEARNOPENGL_RESOURCEMANAGER_H
@@ -0,0 +1,54 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "SamplerCache.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+
+#include <algorithm>
+
+SamplerState SamplerCache::defaults;
+std::map<SamplerState, GLuint> SamplerCache::samplers;
+
+GLuint SamplerCache::get(const SamplerState& state)
+{
+    auto found = samplers.find(state);
+    if(found != samplers.end())
+    {
+        return found->second;
+    }
+
+    GLuint sampler;
+    glGenSamplers(1, &sampler);
+    glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, (GLint) state.minFilter);
+    glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, (GLint) state.magFilter);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, (GLint) state.wrapS);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, (GLint) state.wrapT);
+    glSamplerParameterf(sampler, GL_TEXTURE_LOD_BIAS, state.lodBias);
+
+    if(state.maxAnisotropy > 1.0f && GLExtensions::anisotropicFiltering)
+    {
+        GLfloat maxSupported = 1.0f;
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxSupported);
+        glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY, std::min(state.maxAnisotropy, maxSupported));
+    }
+
+    samplers.emplace(state, sampler);
+    return sampler;
+}
+
+void SamplerCache::bind(GLuint unit, const SamplerState& state)
+{
+    GLState::bindSampler(unit, get(state));
+}
+
+void SamplerCache::clear()
+{
+    for(auto& [state, sampler] : samplers)
+    {
+        GLState::forgetSampler(sampler);
+        glDeleteSamplers(1, &sampler);
+    }
+    samplers.clear();
+}
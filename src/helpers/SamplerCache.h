@@ -0,0 +1,54 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_SAMPLERCACHE_H
+#define LEARNOPENGL_SAMPLERCACHE_H
+
+#include <glad/glad.h>
+
+#include <map>
+#include <tuple>
+
+// how a texture is sampled, independent of the texture itself
+struct SamplerState
+{
+    GLenum minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    GLenum magFilter = GL_LINEAR;
+    GLenum wrapS = GL_REPEAT;
+    GLenum wrapT = GL_REPEAT;
+    // 1 for none, clamped to what the context supports
+    float maxAnisotropy = 1.0f;
+    float lodBias = 0.0f;
+
+    bool operator<(const SamplerState& other) const
+    {
+        return std::tie(minFilter, magFilter, wrapS, wrapT, maxAnisotropy, lodBias)
+                < std::tie(other.minFilter, other.magFilter, other.wrapS, other.wrapT, other.maxAnisotropy,
+                           other.lodBias);
+    }
+};
+
+// one sampler object per distinct SamplerState, shared by every texture unit using that state.
+// textures carry no sampling state of their own, the sampler bound to their unit decides
+class SamplerCache
+{
+public:
+    // what textures are sampled with unless the caller asks for something else, so filtering can be
+    // changed for everything at once
+    static SamplerState defaults;
+
+    // the sampler object for state, created the first time it's asked for
+    static GLuint get(const SamplerState& state);
+
+    // binds the sampler for state to unit
+    static void bind(GLuint unit, const SamplerState& state = defaults);
+
+    // deletes every sampler object, they're made again when asked for
+    static void clear();
+
+private:
+    static std::map<SamplerState, GLuint> samplers;
+};
+
+#endif //LEARNOPENGL_SAMPLERCACHE_H
@@ -0,0 +1,68 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "SceneFramebuffer.h"
+
+#include <iostream>
+
+SceneFramebuffer::SceneFramebuffer() : framebuffer(0), width(0), height(0)
+{
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &color);
+    glGenRenderbuffers(1, &depth);
+}
+
+SceneFramebuffer::~SceneFramebuffer()
+{
+    glDeleteRenderbuffers(1, &color);
+    glDeleteRenderbuffers(1, &depth);
+    glDeleteFramebuffers(1, &framebuffer);
+}
+
+void SceneFramebuffer::resize(int newWidth, int newHeight)
+{
+    width = newWidth;
+    height = newHeight;
+
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT32F, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "ERROR::SCENE_FRAMEBUFFER::INCOMPLETE " << width << "x" << height << '\n';
+    }
+}
+
+void SceneFramebuffer::begin(int screenWidth, int screenHeight)
+{
+    // a minimized window is 0x0, keep the old storage until it's back.
+    // only a window that starts out minimized gets a 1x1 one, so the framebuffer is complete
+    if(screenWidth <= 0 || screenHeight <= 0)
+    {
+        if(width == 0)
+        {
+            resize(1, 1);
+        }
+    }
+    else if(screenWidth != width || screenHeight != height)
+    {
+        resize(screenWidth, screenHeight);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+void SceneFramebuffer::end()
+{
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
@@ -0,0 +1,39 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_SCENEFRAMEBUFFER_H
+#define LEARNOPENGL_SCENEFRAMEBUFFER_H
+
+#include <glad/glad.h>
+
+// screen sized render target with a 32-bit float depth buffer, which the default framebuffer can't be asked for.
+// reverse-Z needs one: floats are densest near 0, where reverse-Z puts far away depths. the color is blitted
+// to the default framebuffer at the end of the frame
+class SceneFramebuffer
+{
+public:
+    GLuint framebuffer;
+    int width;
+    int height;
+
+    SceneFramebuffer();
+    ~SceneFramebuffer();
+
+    SceneFramebuffer(const SceneFramebuffer&) = delete;
+    SceneFramebuffer& operator=(const SceneFramebuffer&) = delete;
+
+    // follows the screen size and binds the framebuffer, clearing is up to the caller
+    void begin(int screenWidth, int screenHeight);
+
+    // copies the color to the default framebuffer and binds that again
+    void end();
+
+private:
+    GLuint color = 0;
+    GLuint depth = 0;
+
+    void resize(int newWidth, int newHeight);
+};
+
+#endif //LEARNOPENGL_SCENEFRAMEBUFFER_H
@@ -3,112 +3,400 @@
 //
 
 #include "Shader.h"
+#include "UniformBlocks.h"
+#include "ProgramBinaryCache.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+
+#include <cstring>
+
+Shader::UniformStats Shader::frameStats {};
+
+// bytes needed to mirror a uniform of this type, samplers are stored as their int unit
+// how a uniform's value is read back from the program, and how many bytes one element of it takes
+enum class UniformComponent
+{
+    Unknown,
+    Float,
+    Double,
+    Int,
+    UnsignedInt
+};
+
+struct UniformLayout
+{
+    UniformComponent component;
+    std::size_t size;
+};
+
+static UniformLayout uniformLayout(GLenum type)
+{
+    switch(type)
+    {
+        case GL_FLOAT: return {UniformComponent::Float, 4};
+        case GL_FLOAT_VEC2: return {UniformComponent::Float, 8};
+        case GL_FLOAT_VEC3: return {UniformComponent::Float, 12};
+        case GL_FLOAT_VEC4: return {UniformComponent::Float, 16};
+        case GL_FLOAT_MAT2: return {UniformComponent::Float, 16};
+        case GL_FLOAT_MAT2x3: return {UniformComponent::Float, 24};
+        case GL_FLOAT_MAT2x4: return {UniformComponent::Float, 32};
+        case GL_FLOAT_MAT3x2: return {UniformComponent::Float, 24};
+        case GL_FLOAT_MAT3: return {UniformComponent::Float, 36};
+        case GL_FLOAT_MAT3x4: return {UniformComponent::Float, 48};
+        case GL_FLOAT_MAT4x2: return {UniformComponent::Float, 32};
+        case GL_FLOAT_MAT4x3: return {UniformComponent::Float, 48};
+        case GL_FLOAT_MAT4: return {UniformComponent::Float, 64};
+
+        case GL_DOUBLE: return {UniformComponent::Double, 8};
+        case GL_DOUBLE_VEC2: return {UniformComponent::Double, 16};
+        case GL_DOUBLE_VEC3: return {UniformComponent::Double, 24};
+        case GL_DOUBLE_VEC4: return {UniformComponent::Double, 32};
+        case GL_DOUBLE_MAT2: return {UniformComponent::Double, 32};
+        case GL_DOUBLE_MAT2x3: return {UniformComponent::Double, 48};
+        case GL_DOUBLE_MAT2x4: return {UniformComponent::Double, 64};
+        case GL_DOUBLE_MAT3x2: return {UniformComponent::Double, 48};
+        case GL_DOUBLE_MAT3: return {UniformComponent::Double, 72};
+        case GL_DOUBLE_MAT3x4: return {UniformComponent::Double, 96};
+        case GL_DOUBLE_MAT4x2: return {UniformComponent::Double, 64};
+        case GL_DOUBLE_MAT4x3: return {UniformComponent::Double, 96};
+        case GL_DOUBLE_MAT4: return {UniformComponent::Double, 128};
+
+        case GL_INT: case GL_BOOL: return {UniformComponent::Int, 4};
+        case GL_INT_VEC2: case GL_BOOL_VEC2: return {UniformComponent::Int, 8};
+        case GL_INT_VEC3: case GL_BOOL_VEC3: return {UniformComponent::Int, 12};
+        case GL_INT_VEC4: case GL_BOOL_VEC4: return {UniformComponent::Int, 16};
+
+        case GL_UNSIGNED_INT: return {UniformComponent::UnsignedInt, 4};
+        case GL_UNSIGNED_INT_VEC2: return {UniformComponent::UnsignedInt, 8};
+        case GL_UNSIGNED_INT_VEC3: return {UniformComponent::UnsignedInt, 12};
+        case GL_UNSIGNED_INT_VEC4: return {UniformComponent::UnsignedInt, 16};
+
+        // samplers and images hold the unit they read from
+        case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_1D_SHADOW: case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_CUBE_SHADOW:
+        case GL_SAMPLER_1D_ARRAY: case GL_SAMPLER_2D_ARRAY: case GL_SAMPLER_CUBE_MAP_ARRAY:
+        case GL_SAMPLER_1D_ARRAY_SHADOW: case GL_SAMPLER_2D_ARRAY_SHADOW: case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+        case GL_SAMPLER_2D_MULTISAMPLE: case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_SAMPLER_BUFFER: case GL_SAMPLER_2D_RECT: case GL_SAMPLER_2D_RECT_SHADOW:
+        case GL_INT_SAMPLER_1D: case GL_INT_SAMPLER_2D: case GL_INT_SAMPLER_3D: case GL_INT_SAMPLER_CUBE:
+        case GL_INT_SAMPLER_1D_ARRAY: case GL_INT_SAMPLER_2D_ARRAY: case GL_INT_SAMPLER_CUBE_MAP_ARRAY:
+        case GL_INT_SAMPLER_2D_MULTISAMPLE: case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_INT_SAMPLER_BUFFER: case GL_INT_SAMPLER_2D_RECT:
+        case GL_UNSIGNED_INT_SAMPLER_1D: case GL_UNSIGNED_INT_SAMPLER_2D: case GL_UNSIGNED_INT_SAMPLER_3D:
+        case GL_UNSIGNED_INT_SAMPLER_CUBE: case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY: case GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE: case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_BUFFER: case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+        case GL_IMAGE_1D: case GL_IMAGE_2D: case GL_IMAGE_3D: case GL_IMAGE_2D_RECT: case GL_IMAGE_CUBE:
+        case GL_IMAGE_BUFFER: case GL_IMAGE_1D_ARRAY: case GL_IMAGE_2D_ARRAY: case GL_IMAGE_CUBE_MAP_ARRAY:
+        case GL_IMAGE_2D_MULTISAMPLE: case GL_IMAGE_2D_MULTISAMPLE_ARRAY:
+        case GL_INT_IMAGE_1D: case GL_INT_IMAGE_2D: case GL_INT_IMAGE_3D: case GL_INT_IMAGE_2D_RECT:
+        case GL_INT_IMAGE_CUBE: case GL_INT_IMAGE_BUFFER: case GL_INT_IMAGE_1D_ARRAY: case GL_INT_IMAGE_2D_ARRAY:
+        case GL_INT_IMAGE_CUBE_MAP_ARRAY: case GL_INT_IMAGE_2D_MULTISAMPLE: case GL_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+        case GL_UNSIGNED_INT_IMAGE_1D: case GL_UNSIGNED_INT_IMAGE_2D: case GL_UNSIGNED_INT_IMAGE_3D:
+        case GL_UNSIGNED_INT_IMAGE_2D_RECT: case GL_UNSIGNED_INT_IMAGE_CUBE: case GL_UNSIGNED_INT_IMAGE_BUFFER:
+        case GL_UNSIGNED_INT_IMAGE_1D_ARRAY: case GL_UNSIGNED_INT_IMAGE_2D_ARRAY:
+        case GL_UNSIGNED_INT_IMAGE_CUBE_MAP_ARRAY: case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE:
+        case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+            return {UniformComponent::Int, 4};
+
+        default:
+            return {UniformComponent::Unknown, 0};
+    }
+}
+
+// current value of every element of the uniform, as the set() overloads store it. arrays have a location per element
+static void readUniform(GLuint program, GLint location, UniformLayout layout, GLint size, unsigned char* out)
+{
+    for(GLint i = 0; i < size; i++, out += layout.size)
+    {
+        switch(layout.component)
+        {
+            case UniformComponent::Float:
+                glGetnUniformfv(program, location + i, (GLsizei) layout.size, (GLfloat*) out);
+                break;
+            case UniformComponent::Double:
+                glGetnUniformdv(program, location + i, (GLsizei) layout.size, (GLdouble*) out);
+                break;
+            case UniformComponent::Int:
+                glGetnUniformiv(program, location + i, (GLsizei) layout.size, (GLint*) out);
+                break;
+            case UniformComponent::UnsignedInt:
+                glGetnUniformuiv(program, location + i, (GLsizei) layout.size, (GLuint*) out);
+                break;
+            case UniformComponent::Unknown:
+                break;
+        }
+    }
+}
 
 Shader::Shader(const char* vertexShaderPath, const char* fragmentShaderPath)
 {
-    // stores source code of vertex and fragment shaders
-    std::string vertexCode {};
-    std::string fragmentCode {};
+    submit(readFile(vertexShaderPath), readFile(fragmentShaderPath));
+    finish();
+}
 
-    // file streams read from shader files to get source code
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
+Shader::Shader()
+{
+    ID = 0;
+}
 
-    // allows ifstreams to throw exceptions
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+void Shader::submit(const std::string& vertexCode, const std::string& fragmentCode)
+{
+    submitStages({{GL_VERTEX_SHADER, vertexCode}, {GL_FRAGMENT_SHADER, fragmentCode}}, false);
+}
 
-    try
-    {
-        // open file path
-        vShaderFile.open(vertexShaderPath);
-        fShaderFile.open(fragmentShaderPath);
+void Shader::submitStages(const std::vector<StageSource>& stages, bool separable)
+{
+    ID = glCreateProgram();
 
-        // read from buffer into string stream, copy to source code
-        std::stringstream vShaderStream, fShaderStream;
+    // a separable program can't be swapped for a monolithic binary of the same source
+    std::vector<std::string_view> keyParts {separable ? "separable" : "monolithic"};
+    for(const StageSource& stage : stages)
+    {
+        keyParts.emplace_back(stageName(stage.type));
+        keyParts.emplace_back(stage.spirv ? "spirv" : "glsl");
+        keyParts.emplace_back(stage.code);
+        keyParts.emplace_back((const char*) stage.constantIds.data(), stage.constantIds.size() * sizeof(GLuint));
+        keyParts.emplace_back((const char*) stage.constantValues.data(), stage.constantValues.size() * sizeof(GLuint));
+    }
+    cacheKey = ProgramBinaryCache::key(keyParts);
 
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
+    pending = true;
+    pendingStages.clear();
 
-        vShaderFile.close();
-        fShaderFile.close();
+    if(separable)
+    {
+        glProgramParameteri(ID, GL_PROGRAM_SEPARABLE, GL_TRUE);
+    }
 
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
+    // a binary from a previous run skips compiling and linking entirely
+    if(ProgramBinaryCache::load(ID, cacheKey))
+    {
+        return;
+    }
 
+    // no status queries here, those would wait for the driver's compiler threads
+    for(const StageSource& stage : stages)
+    {
+        GLuint shader = compileStage(stage);
+        glAttachShader(ID, shader);
+        pendingStages.push_back({stage.type, shader});
     }
-    catch(std::ifstream::failure &e)
+
+    // lets the driver hand the linked program back to the binary cache
+    glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+    glLinkProgram(ID);
+}
+
+bool Shader::isReady() const
+{
+    if(!pending || pendingStages.empty() || !GLExtensions::parallelShaderCompile)
     {
-        std::cout << "ERROR: SHADER FILE NOT SUCCESSFULLY READ\n";
+        return true;
     }
 
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
+    GLint completed = GL_FALSE;
+    glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
 
-    GLuint vertex;
-    GLuint fragment;
+bool Shader::finish()
+{
+    if(!pending)
+    {
+        return linked;
+    }
+    pending = false;
+
+    // loaded from the binary cache, already linked
+    if(pendingStages.empty())
+    {
+        linked = true;
+        reflect();
+        return linked;
+    }
 
     int success;
     char infoLog[512];
 
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, nullptr);
-    glCompileShader(vertex);
+    for(const PendingStage& stage : pendingStages)
+    {
+        checkStage(stage.type, stage.shader);
+    }
 
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
+    glGetProgramiv(ID, GL_LINK_STATUS, &success);
     if(!success)
     {
-        glGetShaderInfoLog(vertex, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+        glGetProgramInfoLog(ID, 512, nullptr, infoLog);
+        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
     }
+    linked = success;
 
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, nullptr);
-    glCompileShader(fragment);
+    for(const PendingStage& stage : pendingStages)
+    {
+        glDetachShader(ID, stage.shader);
+        glDeleteShader(stage.shader);
+    }
+    pendingStages.clear();
 
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if(!success)
+    if(linked)
     {
-        glGetShaderInfoLog(fragment, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+        ProgramBinaryCache::store(ID, cacheKey);
+        reflect();
     }
+    return linked;
+}
 
-    ID = glCreateProgram();
+void Shader::discard()
+{
+    for(const PendingStage& stage : pendingStages)
+    {
+        glDetachShader(ID, stage.shader);
+        glDeleteShader(stage.shader);
+    }
+    pendingStages.clear();
+    pending = false;
 
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
+    if(ID != 0)
+    {
+        GLState::forgetProgram(ID);
+        glDeleteProgram(ID);
+    }
+    *this = Shader();
+}
 
-    glLinkProgram(ID);
+std::string Shader::readFile(const char* path)
+{
+    // file stream reads from shader file to get source code
+    std::ifstream shaderFile;
 
-    glGetProgramiv(ID, GL_LINK_STATUS, &success);
+    // allows ifstream to throw exceptions
+    shaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+    try
+    {
+        // binary so SPIR-V modules come through untouched, glsl doesn't mind the \r\n
+        shaderFile.open(path, std::ios::binary);
+
+        // read from buffer into string stream, copy to source code
+        std::stringstream shaderStream;
+        shaderStream << shaderFile.rdbuf();
+        shaderFile.close();
+
+        return shaderStream.str();
+    }
+    catch(std::ifstream::failure &e)
+    {
+        std::cout << "ERROR: SHADER FILE NOT SUCCESSFULLY READ " << path << '\n';
+    }
+
+    return {};
+}
+
+GLuint Shader::compileStage(const StageSource& stage)
+{
+    GLuint shader = glCreateShader(stage.type);
+
+    // a SPIR-V module is already parsed, specializing it replaces the compile
+    if(stage.spirv)
+    {
+        glShaderBinary(1, &shader, GL_SHADER_BINARY_FORMAT_SPIR_V_ARB, stage.code.data(), (GLsizei) stage.code.size());
+        GLExtensions::glSpecializeShaderARB(shader, "main", (GLuint) stage.constantIds.size(),
+                                            stage.constantIds.data(), stage.constantValues.data());
+        return shader;
+    }
+
+    const char* code = stage.code.c_str();
+    glShaderSource(shader, 1, &code, nullptr);
+    glCompileShader(shader);
+
+    return shader;
+}
+
+const char* Shader::stageName(GLenum type)
+{
+    switch(type)
+    {
+        case GL_VERTEX_SHADER: return "VERTEX";
+        case GL_FRAGMENT_SHADER: return "FRAGMENT";
+        case GL_GEOMETRY_SHADER: return "GEOMETRY";
+        case GL_COMPUTE_SHADER: return "COMPUTE";
+        default: return "UNKNOWN";
+    }
+}
+
+void Shader::checkStage(GLenum type, GLuint shader)
+{
+    int success;
+    char infoLog[512];
+
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
     if(!success)
     {
-        glGetProgramInfoLog(ID, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+        std::cout << "ERROR::SHADER::" << stageName(type) << "::COMPILATION_FAILED\n" << infoLog << std::endl;
     }
+}
 
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+void Shader::reflect()
+{
+    // attach shared blocks (camera, light...) to their fixed binding points
+    for(const UniformBlockInfo& block : UNIFORM_BLOCKS)
+    {
+        GLuint blockIndex = glGetUniformBlockIndex(ID, block.name);
+        if(blockIndex != GL_INVALID_INDEX)
+        {
+            glUniformBlockBinding(ID, blockIndex, block.binding);
+        }
+    }
 
     // amount of uniforms in shader
     GLint locationCount;
-    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &locationCount);
+    glGetProgramInterfaceiv(ID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &locationCount);
+
+    // locations come from the interface query, not from looking the name up:
+    // programs made from SPIR-V only have names if the driver kept the module's debug names
+    const GLenum properties[] = {GL_LOCATION, GL_TYPE, GL_ARRAY_SIZE};
 
-    std::vector<std::string> auxUniforms;
     for(int i = 0; i < locationCount; i++)
     {
         int length;
         char buffer[100];
-        GLint size;
-        GLenum type;
+        GLint values[3];
 
-        glGetActiveUniform(ID, GLuint(i), sizeof(buffer)-1, &length, &size, &type, buffer);
+        glGetProgramResourceiv(ID, GL_UNIFORM, GLuint(i), 3, properties, 3, nullptr, values);
+        glGetProgramResourceName(ID, GL_UNIFORM, GLuint(i), sizeof(buffer)-1, &length, buffer);
         buffer[length] = 0;
         std::string name = std::string(buffer);
 
-        GLint location = glGetUniformLocation(ID, name.c_str());
+        GLint location = values[0];
+        GLenum type = values[1];
+        GLint size = values[2];
+
+        if(name.empty())
+        {
+            std::cout << "ERROR::SHADER::UNNAMED_UNIFORM at location " << location
+                      << ", handles can't be resolved by name\n";
+        }
 
         locations[name] = location;
+
+        // uniforms in blocks have no location and no shadow. the shadow starts out as what the program holds,
+        // initializers and layout(binding = N) included, so the first set() is only skipped when it changes nothing.
+        // types we can't size get an empty shadow, nothing is read back and every set() is uploaded
+        GLint slot = -1;
+        if(location != -1)
+        {
+            UniformLayout layout = uniformLayout(type);
+            slot = (GLint) shadowSlots.size();
+            shadowSlots.push_back({shadowData.size(), layout.size * size});
+            shadowData.resize(shadowData.size() + shadowSlots.back().size, 0);
+            readUniform(ID, location, layout, size, shadowData.data() + shadowSlots.back().offset);
+        }
+
+        hashedLocations.emplace(fnv1a32(name), HashedUniform{name, {location, slot}});
     }
 
     std::cout << locationCount << '\n';
@@ -116,169 +404,220 @@ Shader::Shader(const char* vertexShaderPath, const char* fragmentShaderPath)
 
 void Shader::use() const
 {
-    glUseProgram(ID);
+    GLState::useProgram(ID);
 }
 
-// only works for uniforms being used in shader
-void Shader::setBool(const std::string& name, bool value) const
+Shader::UniformInfo Shader::findUniform(const UniformName& name) const
 {
-    if(locations.contains(name))
+    auto [first, last] = hashedLocations.equal_range(name.hash);
+    for(auto it = first; it != last; it++)
     {
-        glUniform1i(locations.at(name), (int) value);
+        if(it->second.name == name.str)
+        {
+            return it->second.info;
+        }
     }
-    else
+    return {-1, -1};
+}
+
+bool Shader::updateShadow(GLint slot, const void* value, std::size_t size) const
+{
+    if(slot == -1)
     {
-        std::cout << name << " does not exist!\n";
+        return false;
     }
+
+    const ShadowSlot& shadow = shadowSlots[slot];
+
+    // value doesn't fit the declared type, upload without caching
+    if(size > shadow.size)
+    {
+        stats.uploads++;
+        frameStats.uploads++;
+        return true;
+    }
+
+    unsigned char* current = shadowData.data() + shadow.offset;
+    if(std::memcmp(current, value, size) == 0)
+    {
+        stats.elided++;
+        frameStats.elided++;
+        return false;
+    }
+
+    std::memcpy(current, value, size);
+    stats.uploads++;
+    frameStats.uploads++;
+    return true;
 }
 
-// only works for uniforms being used in shader
-void Shader::setFloat(const std::string &name, float value) const
+void Shader::set(UniformHandle<bool> uniform, bool value) const
 {
-    if(locations.contains(name))
+    int intValue = value;
+    if(updateShadow(uniform.slot, &intValue, sizeof(intValue)))
     {
-        glUniform1f(locations.at(name), value);
+        glProgramUniform1i(ID, uniform.location, intValue);
     }
-    else
+}
+
+void Shader::set(UniformHandle<int> uniform, int value) const
+{
+    if(updateShadow(uniform.slot, &value, sizeof(value)))
     {
-        std::cout << name << " does not exist!\n";
+        glProgramUniform1i(ID, uniform.location, value);
     }
 }
 
-// only works for uniforms being used in shader
-void Shader::setInt(const std::string &name, int value) const
+void Shader::set(UniformHandle<float> uniform, float value) const
 {
-    if(locations.contains(name))
+    if(updateShadow(uniform.slot, &value, sizeof(value)))
     {
-        glUniform1i(locations.at(name), value);
+        glProgramUniform1f(ID, uniform.location, value);
     }
-    else
+}
+
+void Shader::set(UniformHandle<Texture2D> uniform, const GLuint texUnit, const Texture2D& value) const
+{
+    if(uniform.valid())
     {
-        std::cout << name << " does not exist!\n";
+        value.use(texUnit);
+        set(UniformHandle<int>{uniform.location, uniform.slot}, (int)texUnit);
     }
 }
 
-// only works for uniforms being used in shader
-void Shader::setTexture2D(const std::string &name, const GLuint texUnit, const Texture2D& value) const
+void Shader::set(UniformHandle<TextureArray> uniform, const GLuint texUnit, const TextureArray& value) const
 {
-    if(locations.contains(name))
+    if(uniform.valid())
     {
         value.use(texUnit);
-        setInt(name, (int)texUnit);
+        set(UniformHandle<int>{uniform.location, uniform.slot}, (int)texUnit);
     }
-    else
+}
+
+void Shader::set(UniformHandle<glm::vec2> uniform, const glm::vec2& value) const
+{
+    if(updateShadow(uniform.slot, &value[0], sizeof(value)))
     {
-        //std::cout << name << " does not exist!\n";
+        glProgramUniform2fv(ID, uniform.location, 1, &value[0]);
     }
 }
 
-// only works for uniforms being used in shader
-void Shader::setVec2(const std::string &name, const glm::vec2 &value) const
+void Shader::set(UniformHandle<glm::vec3> uniform, const glm::vec3& value) const
 {
-    if(locations.contains(name))
+    if(updateShadow(uniform.slot, &value[0], sizeof(value)))
     {
-        glUniform2fv(locations.at(name), 1, &value[0]);
+        glProgramUniform3fv(ID, uniform.location, 1, &value[0]);
     }
-    else
+}
+
+void Shader::set(UniformHandle<glm::vec4> uniform, const glm::vec4& value) const
+{
+    if(updateShadow(uniform.slot, &value[0], sizeof(value)))
     {
-        std::cout << name << " does not exist!\n";
+        glProgramUniform4fv(ID, uniform.location, 1, &value[0]);
     }
 }
 
-// only works for uniforms being used in shader
-void Shader::setVec2(const std::string &name, float x, float y) const
+void Shader::set(UniformHandle<glm::mat2> uniform, const glm::mat2& mat) const
 {
-    if(locations.contains(name))
+    if(updateShadow(uniform.slot, &mat[0][0], sizeof(mat)))
     {
-        glUniform2f(locations.at(name), x, y);
+        glProgramUniformMatrix2fv(ID, uniform.location, 1, GL_FALSE, &mat[0][0]);
     }
-    else
+}
+
+void Shader::set(UniformHandle<glm::mat3> uniform, const glm::mat3& mat) const
+{
+    if(updateShadow(uniform.slot, &mat[0][0], sizeof(mat)))
     {
-        std::cout << name << " does not exist!\n";
+        glProgramUniformMatrix3fv(ID, uniform.location, 1, GL_FALSE, &mat[0][0]);
     }
-    glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
 }
 
-// only works for uniforms being used in shader
-void Shader::setVec3(const std::string &name, const glm::vec3 &value) const
+void Shader::set(UniformHandle<glm::mat4> uniform, const glm::mat4& mat) const
 {
-    if (locations.contains(name))
-    {
-        glUniform3fv(locations.at(name), 1, &value[0]);
-    } else
+    if(updateShadow(uniform.slot, &mat[0][0], sizeof(mat)))
     {
-        std::cout << name << " does not exist!\n";
+        glProgramUniformMatrix4fv(ID, uniform.location, 1, GL_FALSE, glm::value_ptr(mat));
     }
 }
 
+// only works for uniforms being used in shader
+void Shader::setBool(const std::string& name, bool value) const
+{
+    set(getUniform<bool>(name), value);
+}
+
+// only works for uniforms being used in shader
+void Shader::setFloat(const std::string &name, float value) const
+{
+    set(getUniform<float>(name), value);
+}
+
+// only works for uniforms being used in shader
+void Shader::setInt(const std::string &name, int value) const
+{
+    set(getUniform<int>(name), value);
+}
+
+// only works for uniforms being used in shader
+void Shader::setTexture2D(const std::string &name, const GLuint texUnit, const Texture2D& value) const
+{
+    // missing samplers are not reported, unused texture slots are common
+    UniformInfo info = findUniform(name);
+    set(UniformHandle<Texture2D>{info.location, info.slot}, texUnit, value);
+}
+
+// only works for uniforms being used in shader
+void Shader::setVec2(const std::string &name, const glm::vec2 &value) const
+{
+    set(getUniform<glm::vec2>(name), value);
+}
+
+// only works for uniforms being used in shader
+void Shader::setVec2(const std::string &name, float x, float y) const
+{
+    set(getUniform<glm::vec2>(name), glm::vec2(x, y));
+}
+
+// only works for uniforms being used in shader
+void Shader::setVec3(const std::string &name, const glm::vec3 &value) const
+{
+    set(getUniform<glm::vec3>(name), value);
+}
+
 // only works for uniforms being used in shader
 void Shader::setVec3(const std::string &name, float x, float y, float z) const
 {
-    if (locations.contains(name))
-    {
-        glUniform3f(locations.at(name), x, y, z);
-    } else
-    {
-        std::cout << name << " does not exist!\n";
-    }
+    set(getUniform<glm::vec3>(name), glm::vec3(x, y, z));
 }
+
 // only works for uniforms being used in shader
 void Shader::setVec4(const std::string &name, const glm::vec4 &value) const
 {
-    if (locations.contains(name))
-    {
-        glUniform4fv(locations.at(name), 1, &value[0]);
-    } else
-    {
-        std::cout << name << " does not exist!\n";
-    }
+    set(getUniform<glm::vec4>(name), value);
 }
 
 // only works for uniforms being used in shader
 void Shader::setVec4(const std::string &name, float x, float y, float z, float w) const
 {
-    if (locations.contains(name))
-    {
-        glUniform4f(locations.at(name), x, y, z, w);
-    } else
-    {
-        std::cout << name << " does not exist!\n";
-    }
+    set(getUniform<glm::vec4>(name), glm::vec4(x, y, z, w));
 }
 
 // only works for uniforms being used in shader
 void Shader::setMat2(const std::string &name, const glm::mat2 &mat) const
 {
-    if(locations.contains(name))
-    {
-        glUniformMatrix2fv(locations.at(name), 1, GL_FALSE, &mat[0][0]);
-    }
-    else
-    {
-        std::cout << name << " does not exist!\n";
-    }
+    set(getUniform<glm::mat2>(name), mat);
 }
 
 // only works for uniforms being used in shader
 void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const
 {
-    if (locations.contains(name))
-    {
-        glUniformMatrix3fv(locations.at(name), 1, GL_FALSE, &mat[0][0]);
-    } else
-    {
-        std::cout << name << " does not exist!\n";
-    }
+    set(getUniform<glm::mat3>(name), mat);
 }
 
 // only works for uniforms being used in shader
 void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const
 {
-    if (locations.contains(name))
-    {
-        glUniformMatrix4fv(locations.at(name), 1, GL_FALSE, glm::value_ptr(mat));
-    } else
-    {
-        std::cout << name << " does not exist!\n";
-    }
+    set(getUniform<glm::mat4>(name), mat);
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 
 #include <glad/glad.h>
 #include "Texture2D.h"
+#include "TextureArray.h"
+#include "Hash.h"
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/glm.hpp>
 
@@ -15,9 +17,34 @@
 #include <sstream>
 #include <iostream>
 
+#include <cstdint>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
+// name of a uniform, hashed at compile time when built from a string literal
+struct UniformName
+{
+    std::uint32_t hash;
+    const char* str;
+
+    template<std::size_t N>
+    consteval UniformName(const char (&name)[N]) : hash(fnv1a32(name, N - 1)), str(name) {}
+
+    UniformName(const std::string& name) : hash(fnv1a32(name)), str(name.c_str()) {}
+};
+
+// uniform location resolved once, typed so the matching glUniform* is picked at compile time
+template<typename T>
+struct UniformHandle
+{
+    GLint location = -1;
+    // index into the program's shadow copy of its uniform values
+    GLint slot = -1;
+
+    [[nodiscard]] bool valid() const { return location != -1; }
+};
+
 class Shader
 {
 public:
@@ -25,11 +52,101 @@ public:
     typedef std::map<const std::string, GLint> UniformLocations;
     UniformLocations locations;
 
+    struct UniformInfo
+    {
+        GLint location;
+        GLint slot;
+    };
+
+    struct HashedUniform
+    {
+        std::string name;
+        UniformInfo info;
+    };
+
+    // same locations keyed by fnv1a32 of the name, used to resolve handles. names that collide share a hash,
+    // so the name is kept to tell them apart
+    typedef std::unordered_multimap<std::uint32_t, HashedUniform> UniformHashes;
+    UniformHashes hashedLocations;
+
+    struct UniformStats
+    {
+        unsigned int uploads = 0;
+        unsigned int elided = 0;
+    };
+
+    // uploads issued/skipped by this program, and by all programs since the last reset
+    mutable UniformStats stats;
+    static UniformStats frameStats;
+
+    // false until finish() saw a successful link
+    bool linked = false;
+
+    // compiles and links right away, blocking until the driver is done
     Shader(const char* vertexShaderPath, const char* fragmentShaderPath);
 
-    // glUseProgram(this)
+    Shader();
+
+    struct StageSource
+    {
+        GLenum type;
+
+        // glsl text, or a SPIR-V module when spirv is set
+        std::string code;
+        bool spirv = false;
+
+        // specialization constant ids and values, SPIR-V only
+        std::vector<GLuint> constantIds;
+        std::vector<GLuint> constantValues;
+    };
+
+    // starts compiling and linking without waiting on the driver, finish() must be called before use
+    void submit(const std::string& vertexCode, const std::string& fragmentCode);
+
+    // any set of stages. separable programs hold a single stage and are combined in program pipelines
+    void submitStages(const std::vector<StageSource>& stages, bool separable);
+
+    // true when finish() won't stall, always true without KHR_parallel_shader_compile
+    [[nodiscard]] bool isReady() const;
+
+    // waits for the link result and reflects the uniforms, false if compiling or linking failed
+    bool finish();
+
+    // deletes the program and any stages a submit left behind, finished or not. the shader is empty afterwards
+    void discard();
+
+    static std::string readFile(const char* path);
+
+    // glUseProgram(this), skipped if it already is the current program
     void use() const;
 
+    // resolve a uniform once (outside the render loop), invalid handle if it isn't used by the shader
+    template<typename T>
+    [[nodiscard]] UniformHandle<T> getUniform(const UniformName& name) const
+    {
+        UniformInfo info = findUniform(name);
+        if(info.location == -1)
+        {
+            std::cout << name.str << " does not exist!\n";
+        }
+        return UniformHandle<T>{info.location, info.slot};
+    }
+
+    // handle setters, no lookups. values equal to the last one sent are not uploaded again.
+    // they write through glProgramUniform*, so the program doesn't have to be bound (or can be a pipeline stage)
+    void set(UniformHandle<bool> uniform, bool value) const;
+    void set(UniformHandle<int> uniform, int value) const;
+    void set(UniformHandle<float> uniform, float value) const;
+    void set(UniformHandle<Texture2D> uniform, GLuint texUnit, const Texture2D& value) const;
+    void set(UniformHandle<TextureArray> uniform, GLuint texUnit, const TextureArray& value) const;
+    void set(UniformHandle<glm::vec2> uniform, const glm::vec2& value) const;
+    void set(UniformHandle<glm::vec3> uniform, const glm::vec3& value) const;
+    void set(UniformHandle<glm::vec4> uniform, const glm::vec4& value) const;
+    void set(UniformHandle<glm::mat2> uniform, const glm::mat2& mat) const;
+    void set(UniformHandle<glm::mat3> uniform, const glm::mat3& mat) const;
+    void set(UniformHandle<glm::mat4> uniform, const glm::mat4& mat) const;
+
+    // string setters look the name up on every call, fine for setup code but not for the render loop
     void setBool(const std::string& name, bool value) const;
     void setInt(const std::string& name, int value) const;
     void setFloat(const std::string& name, float value) const;
@@ -44,6 +161,41 @@ public:
     void setMat2(const std::string &name, const glm::mat2 &mat) const;
     void setMat3(const std::string &name, const glm::mat3 &mat) const;
     void setMat4(const std::string &name, const glm::mat4 &mat) const;
+
+private:
+    struct PendingStage
+    {
+        GLenum type;
+        GLuint shader;
+    };
+
+    // stages and cache key of a submitted program that finish() hasn't looked at yet
+    bool pending = false;
+    std::vector<PendingStage> pendingStages;
+    std::uint64_t cacheKey = 0;
+
+    static const char* stageName(GLenum type);
+    static GLuint compileStage(const StageSource& stage);
+    static void checkStage(GLenum type, GLuint shader);
+
+    // builds the uniform tables and attaches shared uniform blocks, needs a linked program
+    void reflect();
+
+    struct ShadowSlot
+    {
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    // cpu copy of every active uniform's current value, starts zeroed like the program's uniforms
+    mutable std::vector<unsigned char> shadowData;
+    std::vector<ShadowSlot> shadowSlots;
+
+    // by hash, then by name among the uniforms sharing it. {-1, -1} if none has that name
+    [[nodiscard]] UniformInfo findUniform(const UniformName& name) const;
+
+    // copies value into the shadow, returns false if it was already there (upload can be skipped)
+    bool updateShadow(GLint slot, const void* value, std::size_t size) const;
 };
 
 
@@ -0,0 +1,365 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "ShaderLibrary.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+#include "UniformBlocks.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+
+// only needs the camera part of FrameData, a prefix of the block has the same std140 offsets
+static const char* FALLBACK_VERTEX_SHADER = R"(#version 460 core
+layout (location = 0) in vec3 aPos;
+
+layout (std140) uniform FrameData
+{
+    mat4 projection;
+    mat4 view;
+};
+
+uniform mat4 model;
+
+void main()
+{
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
+)";
+
+static const char* FALLBACK_FRAGMENT_SHADER = R"(#version 460 core
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = vec4(0.5, 0.5, 0.5, 1.0);
+}
+)";
+
+static void deleteProgram(GLuint program)
+{
+    GLState::forgetProgram(program);
+    glDeleteProgram(program);
+}
+
+ShaderLibrary::ShaderLibrary()
+{
+    if(GLExtensions::parallelShaderCompile)
+    {
+        // 0xFFFFFFFF lets the driver pick its own thread count
+        GLExtensions::glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    }
+
+    fallback.submit(FALLBACK_VERTEX_SHADER, FALLBACK_FRAGMENT_SHADER);
+    fallback.finish();
+    fallbackModel = fallback.getUniform<glm::mat4>("model");
+}
+
+ShaderLibrary::~ShaderLibrary()
+{
+    clear();
+}
+
+void ShaderLibrary::clear()
+{
+    for(auto& [stages, pipeline] : pipelines)
+    {
+        GLState::forgetProgramPipeline(pipeline.ID);
+        glDeleteProgramPipelines(1, &pipeline.ID);
+    }
+    pipelines.clear();
+
+    for(Entry& entry : entries)
+    {
+        entry.shader.discard();
+        entry.replacement.discard();
+    }
+    entries.clear();
+    permutations.clear();
+
+    fallback.discard();
+    fallbackModel = {};
+}
+
+const std::string& ShaderLibrary::readFile(const std::string& path)
+{
+    auto it = files.find(path);
+    if(it == files.end())
+    {
+        it = files.emplace(path, Shader::readFile(path.c_str())).first;
+    }
+    return it->second;
+}
+
+bool ShaderLibrary::useSpirv(const std::string& directory)
+{
+    if(!GLExtensions::spirv)
+    {
+        std::cout << "SPIR-V shaders aren't supported by this context, compiling glsl\n";
+        return false;
+    }
+    spirvDirectory = directory;
+    return true;
+}
+
+bool ShaderLibrary::loadSpirv(Entry& entry, std::vector<Shader::StageSource>& sources)
+{
+    std::vector<GLuint> constantIds;
+    std::vector<GLuint> constantValues;
+    for(const auto& [name, value] : entry.defines)
+    {
+        auto constant = std::find_if(glsl::specializationConstants.begin(), glsl::specializationConstants.end(),
+                                     [&name](const glsl::SpecializationConstant& c) { return name == c.name; });
+        if(constant == glsl::specializationConstants.end())
+        {
+            std::cout << "ERROR::SHADER::NO_SPECIALIZATION_CONSTANT " << name << " in " << describe(entry) << '\n';
+            continue;
+        }
+        constantIds.push_back(constant->id);
+        constantValues.push_back((GLuint) std::strtoul(value.c_str(), nullptr, 0));
+    }
+
+    std::vector<std::uint64_t> hashes;
+    entry.dependencies.clear();
+
+    for(const Stage& stage : entry.stages)
+    {
+        std::string path = ShaderPreprocessor::normalizePath(
+                spirvDirectory + '/' + std::filesystem::path(stage.path).filename().string() + ".spv");
+        if(!std::filesystem::exists(path))
+        {
+            std::cout << path << " wasn't built, compiling " << describe(entry) << " from glsl\n";
+            return false;
+        }
+
+        const std::string& module = readFile(path);
+        entry.dependencies.push_back(path);
+        hashes.push_back(fnv1a64(module));
+        sources.push_back({stage.type, module, true, constantIds, constantValues});
+    }
+
+    // specialized modules are told apart by their constants, the same defines as the glsl permutations
+    hashes.push_back(ShaderPreprocessor::hashDefines(entry.defines));
+    hashes.push_back(entry.separable);
+    entry.permutationKey = fnv1a64((const char*) hashes.data(), hashes.size() * sizeof(std::uint64_t));
+
+    return true;
+}
+
+std::vector<Shader::StageSource> ShaderLibrary::preprocess(Entry& entry)
+{
+    if(entry.spirv)
+    {
+        std::vector<Shader::StageSource> modules;
+        if(loadSpirv(entry, modules))
+        {
+            return modules;
+        }
+        entry.spirv = false;
+    }
+
+    auto reader = [this](const std::string& path) { return readFile(path); };
+
+    std::vector<Shader::StageSource> sources;
+    std::vector<std::uint64_t> hashes;
+    entry.dependencies.clear();
+
+    for(const Stage& stage : entry.stages)
+    {
+        ShaderPreprocessor::Result result = ShaderPreprocessor::process(stage.path, entry.defines, reader);
+
+        entry.dependencies.insert(entry.dependencies.end(), result.dependencies.begin(), result.dependencies.end());
+        hashes.push_back(result.sourceHash);
+        sources.push_back({stage.type, std::move(result.source)});
+    }
+
+    // (source hash, define set), separable stages never share a program with monolithic ones
+    hashes.push_back(ShaderPreprocessor::hashDefines(entry.defines));
+    hashes.push_back(entry.separable);
+    entry.permutationKey = fnv1a64((const char*) hashes.data(), hashes.size() * sizeof(std::uint64_t));
+
+    return sources;
+}
+
+ShaderLibrary::ShaderId ShaderLibrary::add(Entry entry)
+{
+    std::vector<Shader::StageSource> sources = preprocess(entry);
+
+    auto existing = permutations.find(entry.permutationKey);
+    if(existing != permutations.end())
+    {
+        return existing->second;
+    }
+
+    entry.shader.submitStages(sources, entry.separable);
+
+    ShaderId id = entries.size();
+    permutations[entry.permutationKey] = id;
+    entries.push_back(std::move(entry));
+    return id;
+}
+
+ShaderLibrary::ShaderId ShaderLibrary::submit(const char* vertexShaderPath, const char* fragmentShaderPath,
+                                              const ShaderDefines& defines)
+{
+    Entry entry;
+    entry.stages = {{GL_VERTEX_SHADER, vertexShaderPath}, {GL_FRAGMENT_SHADER, fragmentShaderPath}};
+    entry.spirv = !spirvDirectory.empty();
+    entry.defines = defines;
+    return add(std::move(entry));
+}
+
+ShaderLibrary::ShaderId ShaderLibrary::submitStage(GLenum type, const char* path, const ShaderDefines& defines)
+{
+    Entry entry;
+    entry.stages = {{type, path}};
+    entry.separable = true;
+    entry.spirv = !spirvDirectory.empty();
+    entry.defines = defines;
+    return add(std::move(entry));
+}
+
+GLuint ShaderLibrary::pipeline(ShaderId vertexStage, ShaderId fragmentStage)
+{
+    if(!isReady(vertexStage) || !isReady(fragmentStage))
+    {
+        return 0;
+    }
+
+    Pipeline& pipeline = pipelines[{vertexStage, fragmentStage}];
+    if(pipeline.ID == 0)
+    {
+        glGenProgramPipelines(1, &pipeline.ID);
+    }
+
+    // new pair, or a stage was reloaded into a new program since
+    GLuint vertexProgram = entries[vertexStage].shader.ID;
+    if(pipeline.vertexProgram != vertexProgram)
+    {
+        glUseProgramStages(pipeline.ID, GL_VERTEX_SHADER_BIT, vertexProgram);
+        pipeline.vertexProgram = vertexProgram;
+    }
+
+    GLuint fragmentProgram = entries[fragmentStage].shader.ID;
+    if(pipeline.fragmentProgram != fragmentProgram)
+    {
+        glUseProgramStages(pipeline.ID, GL_FRAGMENT_SHADER_BIT, fragmentProgram);
+        pipeline.fragmentProgram = fragmentProgram;
+    }
+
+    return pipeline.ID;
+}
+
+std::string ShaderLibrary::describe(const Entry& entry)
+{
+    std::string description;
+    for(const Stage& stage : entry.stages)
+    {
+        description += (description.empty() ? "" : ", ") + stage.path;
+    }
+    return description;
+}
+
+void ShaderLibrary::poll()
+{
+    for(Entry& entry : entries)
+    {
+        if(!entry.finished && entry.shader.isReady())
+        {
+            entry.shader.finish();
+            entry.finished = true;
+        }
+
+        if(entry.replacing && entry.replacement.isReady())
+        {
+            entry.replacing = false;
+
+            if(entry.replacement.finish())
+            {
+                deleteProgram(entry.shader.ID);
+
+                // program, uniform locations and shadow are all replaced here at once, between frames
+                entry.shader = entry.replacement;
+                std::cout << "reloaded " << describe(entry) << '\n';
+            }
+            else
+            {
+                deleteProgram(entry.replacement.ID);
+                std::cout << "reload of " << describe(entry) << " failed, keeping the previous program\n";
+            }
+            entry.replacement = Shader();
+        }
+    }
+}
+
+void ShaderLibrary::finishAll()
+{
+    for(Entry& entry : entries)
+    {
+        if(!entry.finished)
+        {
+            entry.shader.finish();
+            entry.finished = true;
+        }
+    }
+}
+
+bool ShaderLibrary::isReady(ShaderId id) const
+{
+    return entries[id].finished && entries[id].shader.linked;
+}
+
+const Shader& ShaderLibrary::get(ShaderId id) const
+{
+    return isReady(id) ? entries[id].shader : fallback;
+}
+
+void ShaderLibrary::reload(const std::vector<ShaderWatcher::Change>& changes)
+{
+    std::vector<std::string> changed;
+    for(const ShaderWatcher::Change& change : changes)
+    {
+        std::string path = ShaderPreprocessor::normalizePath(change.path);
+        files[path] = change.source;
+        changed.push_back(path);
+    }
+
+    for(ShaderId id = 0; id < entries.size(); id++)
+    {
+        Entry& entry = entries[id];
+
+        bool affected = std::any_of(changed.begin(), changed.end(), [&entry](const std::string& path)
+        {
+            return std::find(entry.dependencies.begin(), entry.dependencies.end(), path) != entry.dependencies.end();
+        });
+        if(!affected)
+        {
+            continue;
+        }
+
+        permutations.erase(entry.permutationKey);
+        std::vector<Shader::StageSource> sources = preprocess(entry);
+
+        // never compiled yet, start over with the new source
+        if(!entry.finished)
+        {
+            entry.shader.discard();
+            entry.shader.submitStages(sources, entry.separable);
+        }
+        else
+        {
+            // a newer change supersedes a reload still in flight
+            if(entry.replacing)
+            {
+                entry.replacement.discard();
+            }
+
+            entry.replacement.submitStages(sources, entry.separable);
+            entry.replacing = true;
+        }
+
+        permutations[entry.permutationKey] = id;
+    }
+}
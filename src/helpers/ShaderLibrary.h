@@ -0,0 +1,137 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_SHADERLIBRARY_H
+#define LEARNOPENGL_SHADERLIBRARY_H
+
+#include "Shader.h"
+#include "ShaderWatcher.h"
+#include "ShaderPreprocessor.h"
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// submits every program up front so the driver can compile them in parallel,
+// and hands out a fallback program until each one is linked.
+// sources go through ShaderPreprocessor, and each (source, defines) permutation is only built once
+class ShaderLibrary
+{
+public:
+    typedef std::size_t ShaderId;
+
+    // flat color program drawn in place of programs that aren't ready (or failed)
+    Shader fallback;
+    UniformHandle<glm::mat4> fallbackModel;
+
+    // builds the fallback synchronously and asks the driver for as many compiler threads as it likes
+    ShaderLibrary();
+    // deletes whatever clear() didn't, the context must still be current
+    ~ShaderLibrary();
+
+    // entries hold raw program ids that copies would delete twice
+    ShaderLibrary(const ShaderLibrary&) = delete;
+    ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+    // programs submitted after this load <directory>/<file name>.spv (built by the spirv target) instead of
+    // the glsl text, and defines set the specialization constants of the same name.
+    // false if the context can't load SPIR-V, glsl is used then. hot reload only covers glsl programs
+    bool useSpirv(const std::string& directory);
+
+    // preprocesses both files with defines and starts compiling, returns immediately.
+    // the id of the existing program is returned if this permutation was submitted before
+    ShaderId submit(const char* vertexShaderPath, const char* fragmentShaderPath, const ShaderDefines& defines = {});
+
+    // a single stage as a separable program, to be combined with other stages through pipeline()
+    ShaderId submitStage(GLenum type, const char* path, const ShaderDefines& defines = {});
+
+    // program pipeline made of two separable stages, built once per pair and kept up to date when
+    // a stage is reloaded. 0 until both stages are ready, draw with the fallback then
+    GLuint pipeline(ShaderId vertexStage, ShaderId fragmentStage);
+
+    // finishes programs whose compile completed and swaps in reloaded ones, call once per frame
+    void poll();
+
+    // recompiles every program that uses one of the changed files (includes too). the old program stays in use
+    // until the new one linked, and for good if it doesn't
+    void reload(const std::vector<ShaderWatcher::Change>& changes);
+
+    // blocks until every submitted program is finished
+    void finishAll();
+
+    [[nodiscard]] bool isReady(ShaderId id) const;
+
+    // the real program once it linked, the fallback otherwise
+    [[nodiscard]] const Shader& get(ShaderId id) const;
+
+    // deletes every program, reload in flight and pipeline, the fallback too. for shutdown, before the
+    // context goes away
+    void clear();
+
+private:
+    struct Stage
+    {
+        GLenum type;
+        std::string path;
+    };
+
+    struct Entry
+    {
+        std::vector<Stage> stages;
+        bool separable = false;
+        bool spirv = false;
+        ShaderDefines defines;
+
+        // files all stages were built from, for hot reload
+        std::vector<std::string> dependencies;
+        std::uint64_t permutationKey = 0;
+
+        Shader shader;
+        bool finished = false;
+
+        // recompiled program waiting to be swapped in by poll()
+        Shader replacement;
+        bool replacing = false;
+    };
+
+    struct Pipeline
+    {
+        GLuint ID = 0;
+
+        // stage programs currently attached, they change when a stage is hot reloaded
+        GLuint vertexProgram = 0;
+        GLuint fragmentProgram = 0;
+    };
+
+    std::vector<Entry> entries;
+
+    // where .spv modules are loaded from, empty for glsl
+    std::string spirvDirectory;
+
+    // (source hash, define set) -> program built from it
+    std::unordered_map<std::uint64_t, ShaderId> permutations;
+
+    // (vertex stage, fragment stage) -> pipeline object
+    std::map<std::pair<ShaderId, ShaderId>, Pipeline> pipelines;
+
+    // raw contents of every shader file read so far, hot reload updates it off the render thread
+    std::map<std::string, std::string> files;
+
+    const std::string& readFile(const std::string& path);
+
+    // expands every stage of entry and records what they depend on and which permutation they are
+    std::vector<Shader::StageSource> preprocess(Entry& entry);
+
+    // loads the modules of every stage of entry and turns its defines into specialization constants.
+    // false if a module is missing, entry is then built from glsl
+    bool loadSpirv(Entry& entry, std::vector<Shader::StageSource>& sources);
+
+    ShaderId add(Entry entry);
+
+    [[nodiscard]] static std::string describe(const Entry& entry);
+};
+
+#endif //LEARNOPENGL_SHADERLIBRARY_H
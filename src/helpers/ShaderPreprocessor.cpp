@@ -0,0 +1,118 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "ShaderPreprocessor.h"
+#include "Hash.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+std::string ShaderPreprocessor::normalizePath(const std::string& path)
+{
+    return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+std::uint64_t ShaderPreprocessor::hashDefines(const ShaderDefines& defines)
+{
+    std::uint64_t hash = fnv1a64("");
+    for(const auto& [name, value] : defines)
+    {
+        hash = fnv1a64(name, hash);
+        hash = fnv1a64("=", 1, hash);
+        hash = fnv1a64(value, hash);
+        hash = fnv1a64("\n", 1, hash);
+    }
+    return hash;
+}
+
+// true if line is an #include directive, file gets the quoted name
+static bool parseInclude(const std::string& line, std::string& file)
+{
+    std::size_t start = line.find_first_not_of(" \t");
+    if(start == std::string::npos || line.compare(start, 8, "#include") != 0)
+    {
+        return false;
+    }
+
+    std::size_t open = line.find('"', start + 8);
+    std::size_t close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+    if(close == std::string::npos)
+    {
+        std::cout << "ERROR::SHADER::PREPROCESSOR::BAD_INCLUDE " << line << '\n';
+        return false;
+    }
+
+    file = line.substr(open + 1, close - open - 1);
+    return true;
+}
+
+void ShaderPreprocessor::expand(const std::string& path, const FileReader& reader, Result& result, std::string& body)
+{
+    std::string normalized = normalizePath(path);
+    if(std::find(result.dependencies.begin(), result.dependencies.end(), normalized) != result.dependencies.end())
+    {
+        // every file is included once, so shared headers need no guards
+        return;
+    }
+
+    // #line's second number is a source string index, we use the index into dependencies
+    std::size_t fileIndex = result.dependencies.size();
+    result.dependencies.push_back(normalized);
+
+    std::istringstream stream(reader(normalized));
+    std::string line;
+    int lineNumber = 0;
+
+    while(std::getline(stream, line))
+    {
+        lineNumber++;
+
+        std::string included;
+        if(parseInclude(line, included))
+        {
+            std::filesystem::path includePath = std::filesystem::path(normalized).parent_path() / included;
+            body += "#line 1 " + std::to_string(result.dependencies.size()) + '\n';
+            expand(includePath.string(), reader, result, body);
+            body += "#line " + std::to_string(lineNumber + 1) + ' ' + std::to_string(fileIndex) + '\n';
+            continue;
+        }
+
+        body += line;
+        body += '\n';
+    }
+}
+
+ShaderPreprocessor::Result ShaderPreprocessor::process(const std::string& path, const ShaderDefines& defines,
+                                                       const FileReader& reader)
+{
+    Result result;
+    std::string body;
+    expand(path, reader, result, body);
+
+    result.sourceHash = fnv1a64(body);
+
+    // #version has to stay the first line, the defines go right after it
+    std::size_t versionEnd = 0;
+    std::size_t versionStart = body.find("#version");
+    if(versionStart != std::string::npos)
+    {
+        versionEnd = body.find('\n', versionStart);
+        versionEnd = versionEnd == std::string::npos ? body.size() : versionEnd + 1;
+    }
+
+    std::string injected;
+    for(const auto& [name, value] : defines)
+    {
+        injected += "#define " + name + ' ' + value + '\n';
+    }
+
+    // keeps error line numbers pointing at the file
+    std::size_t versionLine = std::count(body.begin(), body.begin() + (std::ptrdiff_t) versionEnd, '\n');
+    injected += "#line " + std::to_string(versionLine + 1) + " 0\n";
+
+    result.source = body.substr(0, versionEnd) + injected + body.substr(versionEnd);
+    return result;
+}
@@ -0,0 +1,46 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_SHADERPREPROCESSOR_H
+#define LEARNOPENGL_SHADERPREPROCESSOR_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// name -> value, ordered so the same set always hashes the same
+typedef std::map<std::string, std::string> ShaderDefines;
+
+// expands #include "file" (each file at most once, paths relative to the including file)
+// and injects #defines right after #version, so one source can be compiled as specialized variants
+class ShaderPreprocessor
+{
+public:
+    struct Result
+    {
+        std::string source;
+
+        // hash of the expanded source before the defines were injected
+        std::uint64_t sourceHash = 0;
+
+        // every file that went into source, the main file first. normalized paths
+        std::vector<std::string> dependencies;
+    };
+
+    // returns a file's contents, lets callers serve files they already have in memory
+    typedef std::function<std::string(const std::string& path)> FileReader;
+
+    static Result process(const std::string& path, const ShaderDefines& defines, const FileReader& reader);
+
+    static std::uint64_t hashDefines(const ShaderDefines& defines);
+
+    static std::string normalizePath(const std::string& path);
+
+private:
+    static void expand(const std::string& path, const FileReader& reader, Result& result, std::string& body);
+};
+
+#endif //LEARNOPENGL_SHADERPREPROCESSOR_H
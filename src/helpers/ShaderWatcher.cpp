@@ -0,0 +1,164 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "ShaderWatcher.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+ShaderWatcher::ShaderWatcher(const std::string& directory) : directory(directory), running(true)
+{
+    thread = std::thread(&ShaderWatcher::run, this);
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+    running = false;
+    if(thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+std::vector<ShaderWatcher::Change> ShaderWatcher::takeChanges()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Change> taken;
+    taken.swap(changes);
+    return taken;
+}
+
+void ShaderWatcher::push(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file)
+    {
+        // editors sometimes replace the file in several steps, the final write sends another event
+        return;
+    }
+
+    std::stringstream stream;
+    stream << file.rdbuf();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for(Change& change : changes)
+    {
+        if(change.path == path)
+        {
+            change.source = stream.str();
+            return;
+        }
+    }
+    changes.push_back({path, stream.str()});
+}
+
+#ifdef __linux__
+
+void ShaderWatcher::run()
+{
+    int fd = inotify_init1(IN_NONBLOCK);
+    if(fd == -1)
+    {
+        std::cout << "ERROR::SHADER_WATCHER::COULD_NOT_WATCH " << directory << '\n';
+        return;
+    }
+
+    // inotify isn't recursive, every subdirectory (shader includes) gets its own watch
+    std::map<int, std::filesystem::path> watched;
+    std::vector<std::filesystem::path> directories {directory};
+    std::error_code error;
+    for(const auto& entry : std::filesystem::recursive_directory_iterator(directory, error))
+    {
+        if(entry.is_directory(error))
+        {
+            directories.push_back(entry.path());
+        }
+    }
+
+    for(const std::filesystem::path& path : directories)
+    {
+        int wd = inotify_add_watch(fd, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if(wd == -1)
+        {
+            std::cout << "ERROR::SHADER_WATCHER::COULD_NOT_WATCH " << path << '\n';
+            continue;
+        }
+        watched[wd] = path;
+    }
+
+    // aligned like the kernel's struct inotify_event
+    alignas(inotify_event) char buffer[4096];
+
+    while(running)
+    {
+        // wakes up regularly to notice the destructor
+        pollfd pfd {fd, POLLIN, 0};
+        if(poll(&pfd, 1, 100) <= 0)
+        {
+            continue;
+        }
+
+        ssize_t length = read(fd, buffer, sizeof(buffer));
+        for(ssize_t offset = 0; offset < length;)
+        {
+            const auto* event = (const inotify_event*) (buffer + offset);
+            auto dir = watched.find(event->wd);
+            if(event->len > 0 && dir != watched.end())
+            {
+                push((dir->second / event->name).string());
+            }
+            offset += (ssize_t) (sizeof(inotify_event) + event->len);
+        }
+    }
+
+    close(fd);
+}
+
+#else
+
+void ShaderWatcher::run()
+{
+    namespace fs = std::filesystem;
+
+    std::map<fs::path, fs::file_time_type> writeTimes;
+    bool firstScan = true;
+
+    while(running)
+    {
+        std::error_code error;
+        for(const fs::directory_entry& entry : fs::recursive_directory_iterator(directory, error))
+        {
+            if(!entry.is_regular_file(error))
+            {
+                continue;
+            }
+
+            fs::file_time_type writeTime = entry.last_write_time(error);
+            auto it = writeTimes.find(entry.path());
+            if(it == writeTimes.end() || it->second != writeTime)
+            {
+                writeTimes[entry.path()] = writeTime;
+                if(!firstScan)
+                {
+                    push(entry.path().string());
+                }
+            }
+        }
+        firstScan = false;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    }
+}
+
+#endif
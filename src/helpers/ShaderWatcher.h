@@ -0,0 +1,48 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_SHADERWATCHER_H
+#define LEARNOPENGL_SHADERWATCHER_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// watches a directory on its own thread (inotify on linux, timestamp polling elsewhere)
+// and reads changed files there, so the render thread only picks up finished sources
+class ShaderWatcher
+{
+public:
+    struct Change
+    {
+        std::string path;
+        std::string source;
+    };
+
+    explicit ShaderWatcher(const std::string& directory);
+    ~ShaderWatcher();
+
+    ShaderWatcher(const ShaderWatcher&) = delete;
+    ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+    // files changed since the last call, latest contents only
+    std::vector<Change> takeChanges();
+
+private:
+    std::string directory;
+    std::atomic<bool> running;
+    std::thread thread;
+
+    std::mutex mutex;
+    std::vector<Change> changes;
+
+    void run();
+
+    // reads the file and queues it, replacing an older change to the same file
+    void push(const std::string& path);
+};
+
+#endif //LEARNOPENGL_SHADERWATCHER_H
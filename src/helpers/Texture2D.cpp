@@ -3,59 +3,95 @@
 //
 
 #include "Texture2D.h"
+#include "GLState.h"
+#include "SamplerCache.h"
+#include "BindlessTextures.h"
+#include "TextureBudget.h"
+#include "TextureContainer.h"
+#include "TextureStreamer.h"
 
-Texture2D::Texture2D(const char *texturePath, bool generateMipMaps)
-{
-    // creates an id for the texture object
-    glGenTextures(1, &ID);
-    glBindTexture(GL_TEXTURE_2D, ID);
-
-    // texture wrapping options: tell what to do when texCoords are out of 0-1 range
-    // GL_REPEAT just repeats the texture
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-    // filtering options: tell how to interpret texels (pixel on texture)
-    // linear filtering averages neighboring texels (smooths out texture)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+#include <algorithm>
 
-    unsigned char* data = stbi_load(texturePath, &width, &height, &numChannels, 0);
-
-    if(data)
+Texture2D::Texture2D(const char *texturePath, bool generateMipMaps) : Texture2D()
+{
+    // pre-compressed files are uploaded as they are, with the mip chain they were baked with
+    if(TextureContainer::isContainer(texturePath))
     {
-        // rgb format (jpg)
-        if(numChannels == 3)
-        {
-
-            // first arg is type of texture (doesn't affect bound 1D and 3D textures)
-            // second arg is level of mipmap (if providing manual mipmaps), we use 0 since we will always generate
-            // third is the format that the texture should be
-            // fourth, fifth are dimensions of texture
-            // sixth should be zero for legacy reasons
-            // seventh is format of actual data of file
-            // seventh is type of actual data
-            // eight is actual data
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height
-                            , 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        }
-        // rgba format (png)
-        else if(numChannels == 4)
+        TextureImage image;
+        if(TextureContainer::load(texturePath, image))
         {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height
-                    , 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+            create(image);
+            return;
         }
+    }
+    else if(unsigned char* data = stbi_load(texturePath, &width, &height, &numChannels, 0))
+    {
+        create(data, generateMipMaps);
+        return;
+    }
 
-        if(generateMipMaps)
+    std::cout << "texture " << texturePath << " did not load correctly!\n";
+}
+
+Texture2D::Texture2D(const std::string& texturePath, std::vector<unsigned char> bytes, bool generateMipMaps)
+        : Texture2D()
+{
+    if(TextureContainer::isContainer(texturePath))
+    {
+        TextureImage image;
+        if(TextureContainer::parse(texturePath, std::move(bytes), image))
         {
-            glGenerateMipmap(GL_TEXTURE_2D);
+            create(image);
+            return;
         }
-        stbi_image_free(data);
     }
-    else
+    else if(unsigned char* data = stbi_load_from_memory(bytes.data(), (int) bytes.size(), &width, &height,
+                                                        &numChannels, 0))
     {
-        std::cout << "texture " << ID << " did not load correctly!\n";
+        create(data, generateMipMaps);
+        return;
     }
+
+    std::cout << "texture " << texturePath << " did not load correctly!\n";
+}
+
+void Texture2D::create(const TextureImage& image)
+{
+    // creates an id for the texture object
+    glGenTextures(1, &ID);
+    GLState::bindTexture(GL_TEXTURE_2D, ID);
+
+    width = image.levels[0].width;
+    height = image.levels[0].height;
+    numChannels = image.numChannels;
+    TextureContainer::upload(image, image.data.data());
+    TextureBudget::track(ID, GL_TEXTURE_2D);
+}
+
+void Texture2D::create(unsigned char* data, bool generateMipMaps)
+{
+    glGenTextures(1, &ID);
+    GLState::bindTexture(GL_TEXTURE_2D, ID);
+
+    // immutable storage: every level is allocated once up front, in a sized format, and the texture
+    // can't be respecified afterwards. the levels are then filled like any other texture
+    glTexStorage2D(GL_TEXTURE_2D, generateMipMaps ? mipLevels(width, height) : 1, sizedFormat(numChannels),
+                   width, height);
+
+    // first arg is type of texture (doesn't affect bound 1D and 3D textures)
+    // second arg is level of mipmap (if providing manual mipmaps), we use 0 since we will always generate
+    // third, fourth are the offset into the level and fifth, sixth the size of the region
+    // seventh is format of actual data of file (rgb for jpg, rgba for png)
+    // eight is type of actual data
+    // ninth is actual data
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, pixelFormat(numChannels), GL_UNSIGNED_BYTE, data);
+
+    if(generateMipMaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    stbi_image_free(data);
+    TextureBudget::track(ID, GL_TEXTURE_2D);
 }
 
 Texture2D::Texture2D()
@@ -66,13 +102,97 @@ Texture2D::Texture2D()
     numChannels = 0;
 }
 
+Texture2D::~Texture2D()
+{
+    release();
+}
+
+Texture2D::Texture2D(Texture2D&& other) noexcept
+        : ID(other.ID), width(other.width), height(other.height), numChannels(other.numChannels)
+{
+    other.ID = 0;
+    TextureBudget::move(ID, ID);
+    TextureStreamer::move(ID, *this);
+}
+
+Texture2D& Texture2D::operator=(Texture2D&& other) noexcept
+{
+    if(this != &other)
+    {
+        release();
+        ID = other.ID;
+        width = other.width;
+        height = other.height;
+        numChannels = other.numChannels;
+        other.ID = 0;
+        TextureBudget::move(ID, ID);
+        TextureStreamer::move(ID, *this);
+    }
+    return *this;
+}
+
+void Texture2D::release()
+{
+    if(ID == 0)
+    {
+        return;
+    }
+
+    BindlessTextures::release(ID);
+    TextureBudget::forget(ID);
+    TextureStreamer::forget(ID);
+    GLState::forgetTexture(ID);
+    glDeleteTextures(1, &ID);
+    ID = 0;
+}
+
 void Texture2D::use() const
 {
-    glBindTexture(GL_TEXTURE_2D, ID);
+    TextureBudget::touch(ID);
+    GLState::bindTexture(GL_TEXTURE_2D, ID);
 }
 
-void Texture2D::use(GLuint texUnit) const
+void Texture2D::use(GLuint texUnit, const SamplerState& sampler) const
 {
-    glActiveTexture(GL_TEXTURE0 + texUnit);
-    use();
-}
\ No newline at end of file
+    TextureBudget::touch(ID);
+    GLState::bindTexture(texUnit, GL_TEXTURE_2D, ID);
+    SamplerCache::bind(texUnit, sampler);
+}
+
+GLuint64 Texture2D::handle() const
+{
+    return BindlessTextures::handle(ID);
+}
+
+GLsizei Texture2D::mipLevels(int width, int height)
+{
+    // halving down to 1x1
+    GLsizei levels = 1;
+    for(int size = std::max(width, height); size > 1; size /= 2)
+    {
+        levels++;
+    }
+    return levels;
+}
+
+GLenum Texture2D::sizedFormat(int numChannels)
+{
+    switch(numChannels)
+    {
+        case 1: return GL_R8;
+        case 2: return GL_RG8;
+        case 3: return GL_RGB8;
+        default: return GL_RGBA8;
+    }
+}
+
+GLenum Texture2D::pixelFormat(int numChannels)
+{
+    switch(numChannels)
+    {
+        case 1: return GL_RED;
+        case 2: return GL_RG;
+        case 3: return GL_RGB;
+        default: return GL_RGBA;
+    }
+}
@@ -5,10 +5,16 @@
 #ifndef LEARNOPENGL_TEXTURE2D_H
 #define LEARNOPENGL_TEXTURE2D_H
 
+#include "SamplerCache.h"
+#include "TextureContainer.h"
+
 #include <glad/glad.h>
 #include <iostream>
 #include <stb/stb_image.h>
 
+#include <string>
+#include <vector>
+
 class Texture2D
 {
 public:
@@ -17,13 +23,46 @@ public:
     int height;
     int numChannels;
 
+    // png/jpg through stb_image, or a block compressed .ktx2/.dds (generateMipMaps is ignored, they bring their own).
+    // ID is 0 if the file couldn't be loaded
     explicit Texture2D(const char* texturePath, bool generateMipMaps = true);
 
+    // the same from the file's bytes, already read from texturePath (which picks the decoder)
+    Texture2D(const std::string& texturePath, std::vector<unsigned char> bytes, bool generateMipMaps = true);
+
     Texture2D();
+    ~Texture2D();
+
+    // owns the texture object, so it can only be moved
+    Texture2D(const Texture2D&) = delete;
+    Texture2D& operator=(const Texture2D&) = delete;
+    Texture2D(Texture2D&& other) noexcept;
+    Texture2D& operator=(Texture2D&& other) noexcept;
+
+    // deletes the texture object now, ID is 0 afterwards
+    void release();
 
+    // binding counts as a use for TextureBudget. leaves the active unit's sampler as it is
     void use() const;
 
-    void use(GLuint texUnit) const;
+    // binds the sampler for the unit too, SamplerCache::defaults unless told otherwise
+    void use(GLuint texUnit, const SamplerState& sampler = SamplerCache::defaults) const;
+
+    // resident bindless handle, made on first use and sampled with SamplerCache::defaults as they were then.
+    // 0 without ARB_bindless_texture, use a unit then
+    [[nodiscard]] GLuint64 handle() const;
+
+    // levels of a full mip chain for glTexStorage2D
+    static GLsizei mipLevels(int width, int height);
+
+    // internal format for glTexStorage2D and pixel format for glTexSubImage2D of 8 bit images with numChannels
+    static GLenum sizedFormat(int numChannels);
+    static GLenum pixelFormat(int numChannels);
+
+private:
+    // texture object from a parsed container, or from stb_image pixels (freed afterwards)
+    void create(const TextureImage& image);
+    void create(unsigned char* data, bool generateMipMaps);
 };
 
 #endif //LEARNOPENGL_TEXTURE2D_H
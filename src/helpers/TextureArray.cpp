@@ -0,0 +1,315 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "TextureArray.h"
+#include "RectanglePacker.h"
+#include "GLState.h"
+#include "SamplerCache.h"
+#include "Texture2D.h"
+#include "TextureBudget.h"
+#include "TextureStreamer.h"
+
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <iostream>
+
+TextureArray::TextureArray(const std::vector<std::string>& paths) : TextureArray()
+{
+    Image image;
+    bool prepared = prepare(paths, image);
+    regions = std::move(image.regions);
+    if(!prepared)
+    {
+        return;
+    }
+
+    ID = allocate(image);
+    for(const Image::Slice& slice : image.slices)
+    {
+        upload(image, slice, image.data.data() + slice.offset);
+    }
+    finish(image);
+
+    width = image.width;
+    height = image.height;
+    layers = image.layers;
+    TextureBudget::track(ID, GL_TEXTURE_2D_ARRAY);
+}
+
+TextureArray::TextureArray()
+{
+    ID = 0;
+    width = 0;
+    height = 0;
+    layers = 0;
+}
+
+TextureArray::~TextureArray()
+{
+    release();
+}
+
+TextureArray::TextureArray(TextureArray&& other) noexcept
+        : ID(other.ID), width(other.width), height(other.height), layers(other.layers),
+          regions(std::move(other.regions))
+{
+    other.ID = 0;
+    TextureBudget::move(ID, ID);
+    TextureStreamer::move(ID, *this);
+}
+
+TextureArray& TextureArray::operator=(TextureArray&& other) noexcept
+{
+    if(this != &other)
+    {
+        release();
+        ID = other.ID;
+        width = other.width;
+        height = other.height;
+        layers = other.layers;
+        regions = std::move(other.regions);
+        other.ID = 0;
+        TextureBudget::move(ID, ID);
+        TextureStreamer::move(ID, *this);
+    }
+    return *this;
+}
+
+void TextureArray::release()
+{
+    if(ID == 0)
+    {
+        return;
+    }
+
+    TextureBudget::forget(ID);
+    TextureStreamer::forget(ID);
+    GLState::forgetTexture(ID);
+    glDeleteTextures(1, &ID);
+    ID = 0;
+}
+
+void TextureArray::use(GLuint texUnit) const
+{
+    TextureBudget::touch(ID);
+    GLState::bindTexture(texUnit, GL_TEXTURE_2D_ARRAY, ID);
+    SamplerCache::bind(texUnit);
+}
+
+bool TextureArray::prepare(const std::vector<std::string>& paths, Image& image)
+{
+    image.regions.assign(paths.size(), {});
+
+    std::vector<TextureImage> images(paths.size());
+    std::vector<std::size_t> loaded;
+    for(std::size_t i = 0; i < paths.size(); i++)
+    {
+        if(loadImage(paths[i], images[i]))
+        {
+            loaded.push_back(i);
+        }
+        else
+        {
+            std::cout << "texture " << paths[i] << " did not load correctly!\n";
+        }
+    }
+
+    if(loaded.empty())
+    {
+        return false;
+    }
+
+    const TextureImage& first = images[loaded[0]];
+    bool sameLayout = std::all_of(loaded.begin(), loaded.end(), [&images, &first](std::size_t i)
+    {
+        return images[i].internalFormat == first.internalFormat && images[i].levels.size() == first.levels.size()
+                && images[i].levels[0].width == first.levels[0].width
+                && images[i].levels[0].height == first.levels[0].height;
+    });
+
+    if(sameLayout)
+    {
+        layOutLayers(images, loaded, image);
+        return true;
+    }
+    return layOutPacked(images, loaded, image);
+}
+
+GLuint TextureArray::allocate(const Image& image)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    GLState::bindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, image.levels, image.internalFormat, image.width, image.height, image.layers);
+    return texture;
+}
+
+void TextureArray::upload(const Image& image, const Image::Slice& slice, const void* pixels)
+{
+    if(image.compressed)
+    {
+        glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, slice.level, 0, 0, slice.layer, slice.width, slice.height, 1,
+                                  image.internalFormat, (GLsizei) slice.size, pixels);
+    }
+    else
+    {
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, slice.level, 0, 0, slice.layer, slice.width, slice.height, 1,
+                        GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+}
+
+void TextureArray::finish(const Image& image)
+{
+    if(image.generateMipMaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    }
+}
+
+bool TextureArray::loadImage(const std::string& path, TextureImage& image)
+{
+    if(TextureContainer::isContainer(path))
+    {
+        return TextureContainer::load(path, image);
+    }
+
+    // always 4 channels, every layer of the array has the same format
+    int imageWidth, imageHeight, numChannels;
+    unsigned char* pixels = stbi_load(path.c_str(), &imageWidth, &imageHeight, &numChannels, 4);
+    if(!pixels)
+    {
+        return false;
+    }
+
+    std::size_t size = (std::size_t) imageWidth * imageHeight * 4;
+    image.internalFormat = GL_RGBA8;
+    image.numChannels = numChannels;
+    image.compressed = false;
+    image.levels = {{imageWidth, imageHeight, 0, size}};
+    image.data.assign(pixels, pixels + size);
+
+    stbi_image_free(pixels);
+    return true;
+}
+
+void TextureArray::layOutLayers(std::vector<TextureImage>& images, const std::vector<std::size_t>& loaded,
+                                Image& image)
+{
+    const TextureImage& first = images[loaded[0]];
+    image.internalFormat = first.internalFormat;
+    image.compressed = first.compressed;
+    image.width = first.levels[0].width;
+    image.height = first.levels[0].height;
+    image.layers = (int) loaded.size();
+
+    // single uncompressed levels get their mips generated, everything else brings its own
+    image.generateMipMaps = !first.compressed && first.levels.size() == 1;
+    image.levels = image.generateMipMaps ? Texture2D::mipLevels(image.width, image.height)
+            : (GLsizei) first.levels.size();
+
+    // each layer's levels one after the other, coarsest last
+    for(int layer = 0; layer < image.layers; layer++)
+    {
+        TextureImage& source = images[loaded[layer]];
+        for(std::size_t level = 0; level < source.levels.size(); level++)
+        {
+            const TextureImage::Level& mip = source.levels[level];
+            image.slices.push_back({layer, (GLint) level, mip.width, mip.height, image.data.size() + mip.offset,
+                                    mip.size});
+        }
+        image.data.insert(image.data.end(), source.data.begin(), source.data.end());
+        source.data = {};
+
+        image.regions[loaded[layer]].layer = layer;
+    }
+}
+
+bool TextureArray::layOutPacked(std::vector<TextureImage>& images, const std::vector<std::size_t>& loaded,
+                                Image& image)
+{
+    // only the base level of rgba8 images, the mips are generated over the packed layers
+    std::vector<std::size_t> packed;
+    std::vector<RectanglePacker::Rectangle> rectangles;
+    int width = 0;
+    int height = 0;
+    for(std::size_t i : loaded)
+    {
+        if(images[i].compressed)
+        {
+            std::cout << "ERROR::TEXTURE_ARRAY::COMPRESSED_MAP_NOT_PACKABLE map " << i
+                      << " differs in size or format from the others\n";
+            continue;
+        }
+
+        packed.push_back(i);
+        rectangles.push_back({images[i].levels[0].width + 2 * PADDING, images[i].levels[0].height + 2 * PADDING});
+        width = std::max(width, rectangles.back().width);
+        height = std::max(height, rectangles.back().height);
+    }
+
+    // every map was compressed, there's nothing to pack. the regions stay at layer -1
+    if(packed.empty())
+    {
+        return false;
+    }
+
+    RectanglePacker packer(width, height);
+    packer.pack(rectangles);
+
+    image.internalFormat = GL_RGBA8;
+    image.compressed = false;
+    image.width = width;
+    image.height = height;
+    image.layers = packer.pages;
+    image.generateMipMaps = true;
+
+    // the gutter keeps rectangles apart down to the level where it shrinks to a texel, below that
+    // neighbours would be averaged together. a layer per rectangle has no neighbours
+    image.levels = Texture2D::mipLevels(width, height);
+    if(image.layers < (int) packed.size())
+    {
+        image.levels = std::min(image.levels, Texture2D::mipLevels(PADDING, PADDING));
+    }
+
+    // layers are assembled in memory so the space between rectangles is cleared too
+    const std::size_t layerSize = (std::size_t) width * height * 4;
+    image.data.assign(layerSize * image.layers, 0);
+    for(int layer = 0; layer < image.layers; layer++)
+    {
+        unsigned char* pixels = image.data.data() + layerSize * layer;
+        image.slices.push_back({layer, 0, width, height, layerSize * layer, layerSize});
+
+        for(std::size_t r = 0; r < rectangles.size(); r++)
+        {
+            const RectanglePacker::Rectangle& rectangle = rectangles[r];
+            if(rectangle.page != layer)
+            {
+                continue;
+            }
+
+            const TextureImage::Level& source = images[packed[r]].levels[0];
+            const unsigned char* sourcePixels = images[packed[r]].data.data();
+
+            // the gutter repeats the nearest edge texel
+            for(int y = 0; y < rectangle.height; y++)
+            {
+                int sourceY = std::clamp(y - PADDING, 0, source.height - 1);
+                for(int x = 0; x < rectangle.width; x++)
+                {
+                    int sourceX = std::clamp(x - PADDING, 0, source.width - 1);
+                    std::copy_n(sourcePixels + ((std::size_t) sourceY * source.width + sourceX) * 4, 4,
+                                pixels + ((std::size_t) (rectangle.y + y) * width + rectangle.x + x) * 4);
+                }
+            }
+
+            image.regions[packed[r]].layer = layer;
+            image.regions[packed[r]].rect = glm::vec4((float) (rectangle.x + PADDING) / (float) width,
+                                                      (float) (rectangle.y + PADDING) / (float) height,
+                                                      (float) source.width / (float) width,
+                                                      (float) source.height / (float) height);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,113 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_TEXTUREARRAY_H
+#define LEARNOPENGL_TEXTUREARRAY_H
+
+#include "TextureContainer.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// material maps in the layers of one GL_TEXTURE_2D_ARRAY, so draws using different materials
+// don't need texture binds in between. maps that all have the same size and format get a layer each
+// (with the mips they were loaded with), otherwise they're decoded and packed into rectangles of shared layers
+class TextureArray
+{
+public:
+    // where a map ended up: its layer, and its rectangle in that layer (xy offset, zw size, in uv)
+    struct Region
+    {
+        GLint layer = -1;
+        glm::vec4 rect {0, 0, 1, 1};
+    };
+
+    // everything the texture is made of, decoded and laid out without GL calls so a worker thread can do it.
+    // slices are uploaded one at a time, from data or from the same offsets in a pixel unpack buffer
+    struct Image
+    {
+        // a level of a layer
+        struct Slice
+        {
+            GLint layer;
+            GLint level;
+            int width;
+            int height;
+            std::size_t offset;
+            std::size_t size;
+        };
+
+        GLenum internalFormat = GL_RGBA8;
+        bool compressed = false;
+        int width = 0;
+        int height = 0;
+        int layers = 0;
+        GLsizei levels = 0;
+        // the slices are level 0 only, finish() makes the rest
+        bool generateMipMaps = false;
+
+        std::vector<Slice> slices;
+        std::vector<unsigned char> data;
+        std::vector<Region> regions;
+    };
+
+    GLuint ID;
+    int width;
+    int height;
+    int layers;
+
+    // one per path, same order. layer -1 if the file couldn't be loaded or placed
+    std::vector<Region> regions;
+
+    // png/jpg (decoded with stb_image) or .ktx2/.dds. block compressed maps can't be packed,
+    // they need to share size and format with every other map in the array
+    explicit TextureArray(const std::vector<std::string>& paths);
+
+    TextureArray();
+    ~TextureArray();
+
+    TextureArray(const TextureArray&) = delete;
+    TextureArray& operator=(const TextureArray&) = delete;
+    TextureArray(TextureArray&& other) noexcept;
+    TextureArray& operator=(TextureArray&& other) noexcept;
+
+    // deletes the texture object now, ID is 0 afterwards
+    void release();
+
+    // with the SamplerCache::defaults sampler on the unit
+    void use(GLuint texUnit) const;
+
+    // decodes and lays out the maps, regions included. false if none of them made it into a layer
+    static bool prepare(const std::vector<std::string>& paths, Image& image);
+
+    // new texture object with the image's storage, left bound to GL_TEXTURE_2D_ARRAY. nothing uploaded yet
+    static GLuint allocate(const Image& image);
+
+    // a slice into the bound texture, pixels in memory or the offset in the bound unpack buffer
+    static void upload(const Image& image, const Image::Slice& slice, const void* pixels);
+
+    // after the last slice: generates the mips the image doesn't bring
+    static void finish(const Image& image);
+
+private:
+    // gutter around packed rectangles, filled with their edge texels so filtering and mips don't bleed
+    static constexpr int PADDING = 4;
+
+    static bool loadImage(const std::string& path, TextureImage& image);
+
+    // one layer per image, every level as loaded. the images' data moves into image
+    static void layOutLayers(std::vector<TextureImage>& images, const std::vector<std::size_t>& loaded,
+                             Image& image);
+
+    // rgba8 images packed into layers as big as the biggest one, mips generated (only as far as the gutter
+    // keeps the rectangles apart). false if none of the images could be packed
+    static bool layOutPacked(std::vector<TextureImage>& images, const std::vector<std::size_t>& loaded,
+                             Image& image);
+};
+
+#endif //LEARNOPENGL_TEXTUREARRAY_H
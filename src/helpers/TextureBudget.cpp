@@ -0,0 +1,378 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "TextureBudget.h"
+#include "BindlessTextures.h"
+#include "GLState.h"
+
+#include <algorithm>
+
+TextureBudget::Stats TextureBudget::stats;
+std::size_t TextureBudget::budget = 0;
+std::uint64_t TextureBudget::coldFrames = 300;
+std::unordered_map<GLuint, TextureBudget::Entry> TextureBudget::textures;
+// lastUsed of 0 means never
+std::uint64_t TextureBudget::frame = 1;
+
+void TextureBudget::track(GLuint& id, GLenum target)
+{
+    if(id == 0)
+    {
+        return;
+    }
+
+    forget(id);
+    GLState::bindTexture(target, id);
+
+    Entry entry {&id, target};
+    GLint internalFormat = 0;
+    GLint compressed = GL_FALSE;
+    glGetTexLevelParameteriv(target, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+    glGetTexLevelParameteriv(target, 0, GL_TEXTURE_COMPRESSED, &compressed);
+    entry.internalFormat = (GLenum) internalFormat;
+    entry.compressed = compressed == GL_TRUE;
+
+    // uncompressed texels are read back as rgba8, fine for formats with up to 8 bits per component
+    GLint bits = 0;
+    bool eightBit = true;
+    for(GLenum component : {GL_TEXTURE_RED_SIZE, GL_TEXTURE_GREEN_SIZE, GL_TEXTURE_BLUE_SIZE, GL_TEXTURE_ALPHA_SIZE})
+    {
+        GLint size = 0;
+        glGetTexLevelParameteriv(target, 0, component, &size);
+        bits += size;
+        eightBit = eightBit && size <= 8;
+    }
+    entry.trimmable = entry.compressed || (eightBit && bits > 0);
+
+    // levels that were allocated, up to the first one that wasn't
+    for(GLint level = 0; level < 32; level++)
+    {
+        GLint width = 0, height = 0, depth = 0;
+        glGetTexLevelParameteriv(target, level, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(target, level, GL_TEXTURE_HEIGHT, &height);
+        glGetTexLevelParameteriv(target, level, GL_TEXTURE_DEPTH, &depth);
+        if(width == 0)
+        {
+            break;
+        }
+
+        std::size_t size;
+        if(entry.compressed)
+        {
+            GLint compressedSize = 0;
+            glGetTexLevelParameteriv(target, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressedSize);
+            size = (std::size_t) compressedSize;
+        }
+        else
+        {
+            size = (std::size_t) width * height * std::max(depth, 1) * ((bits + 7) / 8);
+        }
+        entry.levels.push_back({width, height, std::max(depth, 1), size});
+    }
+    entry.droppedTexels.resize(entry.levels.size());
+
+    stats.current += residentBytes(entry);
+    stats.peak = std::max(stats.peak, stats.current);
+    textures.emplace(id, std::move(entry));
+}
+
+void TextureBudget::forget(GLuint id)
+{
+    auto found = textures.find(id);
+    if(found != textures.end())
+    {
+        cancelReadback(found->second);
+        stats.current -= residentBytes(found->second);
+        textures.erase(found);
+    }
+}
+
+void TextureBudget::move(GLuint id, GLuint& newOwner)
+{
+    auto found = textures.find(id);
+    if(found != textures.end())
+    {
+        found->second.owner = &newOwner;
+    }
+}
+
+void TextureBudget::touch(GLuint id)
+{
+    auto found = textures.find(id);
+    if(found != textures.end())
+    {
+        found->second.lastUsed = frame;
+        found->second.wanted = found->second.dropped > 0;
+    }
+}
+
+void TextureBudget::update(int maxChanges)
+{
+    int changes = 0;
+
+    // used while trimmed: all levels back at once, it's on screen
+    std::vector<GLuint> wanted;
+    for(const auto& [id, entry] : textures)
+    {
+        if(entry.wanted)
+        {
+            wanted.push_back(id);
+        }
+    }
+    for(GLuint id : wanted)
+    {
+        if(changes == maxChanges)
+        {
+            break;
+        }
+        Entry& entry = textures.at(id);
+        entry.wanted = false;
+        cancelReadback(entry);
+        reallocate(id, 0);
+        stats.restored++;
+        changes++;
+    }
+
+    // readbacks that arrived: the trim goes through if the texture is still cold, a texture used in
+    // the meantime keeps its levels
+    std::vector<GLuint> arrived;
+    std::size_t trimming = 0;
+    for(auto& [id, entry] : textures)
+    {
+        if(!entry.fence)
+        {
+            continue;
+        }
+
+        for(int level = entry.dropped; level < entry.readbackDropped; level++)
+        {
+            trimming += entry.levels[level].size;
+        }
+        if(changes + (int) arrived.size() < maxChanges && glClientWaitSync(entry.fence, 0, 0) != GL_TIMEOUT_EXPIRED)
+        {
+            arrived.push_back(id);
+        }
+    }
+    for(GLuint id : arrived)
+    {
+        Entry& entry = textures.at(id);
+        for(int level = entry.dropped; level < entry.readbackDropped; level++)
+        {
+            trimming -= entry.levels[level].size;
+        }
+
+        if(entry.lastUsed + coldFrames >= frame || BindlessTextures::has(id))
+        {
+            cancelReadback(entry);
+            continue;
+        }
+
+        int newDropped = entry.readbackDropped;
+        finishReadback(entry);
+        reallocate(id, newDropped);
+        stats.trimmed++;
+        changes++;
+    }
+
+    // a level at a time from the texture unused for longest, the top level is most of its memory.
+    // levels already being read back count as gone
+    while(budget != 0 && stats.current - trimming > budget && changes < maxChanges)
+    {
+        GLuint coldest = 0;
+        std::uint64_t coldestUse = 0;
+        for(const auto& [id, entry] : textures)
+        {
+            bool cold = entry.lastUsed + coldFrames < frame;
+            int next = entry.dropped + 1;
+            bool trimmable = entry.trimmable && !entry.fence && !BindlessTextures::has(id)
+                    && next < (int) entry.levels.size()
+                    && std::max(entry.levels[next].width, entry.levels[next].height) >= MIN_SIZE;
+            if(cold && trimmable && (coldest == 0 || entry.lastUsed < coldestUse))
+            {
+                coldest = id;
+                coldestUse = entry.lastUsed;
+            }
+        }
+
+        if(coldest == 0)
+        {
+            break;
+        }
+        Entry& entry = textures.at(coldest);
+        startTrim(entry, entry.dropped + 1);
+        trimming += entry.levels[entry.dropped].size;
+        changes++;
+    }
+
+    frame++;
+}
+
+std::size_t TextureBudget::readbackBytes(const Entry& entry, int level)
+{
+    const Level& mip = entry.levels[level];
+    return entry.compressed ? mip.size : (std::size_t) mip.width * mip.height * mip.depth * 4;
+}
+
+void TextureBudget::startTrim(Entry& entry, int newDropped)
+{
+    std::size_t size = 0;
+    for(int level = entry.dropped; level < newDropped; level++)
+    {
+        size += readbackBytes(entry, level);
+    }
+
+    glGenBuffers(1, &entry.readback);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, entry.readback);
+    glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr) size, nullptr, GL_STREAM_READ);
+
+    // with a pack buffer bound these only queue the copies, the pointers are offsets into the buffer.
+    // levels of the texture are numbered from its base, entry.dropped
+    GLState::bindTexture(entry.target, *entry.owner);
+    std::size_t offset = 0;
+    for(int level = entry.dropped; level < newDropped; level++)
+    {
+        if(entry.compressed)
+        {
+            glGetCompressedTexImage(entry.target, level - entry.dropped, (void*) offset);
+        }
+        else
+        {
+            glGetTexImage(entry.target, level - entry.dropped, GL_RGBA, GL_UNSIGNED_BYTE, (void*) offset);
+        }
+        offset += readbackBytes(entry, level);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    entry.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    entry.readbackDropped = newDropped;
+}
+
+bool TextureBudget::finishReadback(Entry& entry)
+{
+    if(!entry.fence || glClientWaitSync(entry.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+    {
+        return false;
+    }
+
+    std::size_t size = 0;
+    for(int level = entry.dropped; level < entry.readbackDropped; level++)
+    {
+        size += readbackBytes(entry, level);
+    }
+
+    // the copy is done, mapping doesn't wait
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, entry.readback);
+    const auto* mapped = (const unsigned char*) glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr) size,
+                                                                 GL_MAP_READ_BIT);
+    std::size_t offset = 0;
+    for(int level = entry.dropped; level < entry.readbackDropped; level++)
+    {
+        std::size_t levelSize = readbackBytes(entry, level);
+        entry.droppedTexels[level].assign(mapped + offset, mapped + offset + levelSize);
+        offset += levelSize;
+    }
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    cancelReadback(entry);
+    return true;
+}
+
+void TextureBudget::cancelReadback(Entry& entry)
+{
+    if(!entry.fence)
+    {
+        return;
+    }
+
+    glDeleteSync(entry.fence);
+    glDeleteBuffers(1, &entry.readback);
+    entry.fence = nullptr;
+    entry.readback = 0;
+    entry.readbackDropped = 0;
+}
+
+std::size_t TextureBudget::residentBytes(const Entry& entry)
+{
+    std::size_t bytes = 0;
+    for(std::size_t level = entry.dropped; level < entry.levels.size(); level++)
+    {
+        bytes += entry.levels[level].size;
+    }
+    return bytes;
+}
+
+void TextureBudget::reallocate(GLuint id, int newDropped)
+{
+    auto node = textures.extract(id);
+    Entry& entry = node.mapped();
+    const GLenum target = entry.target;
+    const bool layered = target == GL_TEXTURE_2D_ARRAY;
+    stats.current -= residentBytes(entry);
+
+    // levels of the old texture are numbered from its base, entry.dropped
+    GLuint old = id;
+
+    // sampling state lives in sampler objects, there are no texture parameters to carry over
+    GLuint fresh;
+    glGenTextures(1, &fresh);
+    GLState::bindTexture(target, fresh);
+
+    const Level& base = entry.levels[newDropped];
+    auto count = (GLsizei) (entry.levels.size() - newDropped);
+    if(layered)
+    {
+        glTexStorage3D(target, count, entry.internalFormat, base.width, base.height, base.depth);
+    }
+    else
+    {
+        glTexStorage2D(target, count, entry.internalFormat, base.width, base.height);
+    }
+
+    // levels both textures have are copied on the gpu, the others come from system memory
+    for(int level = newDropped; level < (int) entry.levels.size(); level++)
+    {
+        const Level& mip = entry.levels[level];
+        if(level >= entry.dropped)
+        {
+            glCopyImageSubData(old, target, level - entry.dropped, 0, 0, 0,
+                               fresh, target, level - newDropped, 0, 0, 0, mip.width, mip.height, mip.depth);
+            continue;
+        }
+
+        std::vector<unsigned char>& texels = entry.droppedTexels[level];
+        if(entry.compressed && layered)
+        {
+            glCompressedTexSubImage3D(target, level - newDropped, 0, 0, 0, mip.width, mip.height, mip.depth,
+                                      entry.internalFormat, (GLsizei) texels.size(), texels.data());
+        }
+        else if(entry.compressed)
+        {
+            glCompressedTexSubImage2D(target, level - newDropped, 0, 0, mip.width, mip.height,
+                                      entry.internalFormat, (GLsizei) texels.size(), texels.data());
+        }
+        else if(layered)
+        {
+            glTexSubImage3D(target, level - newDropped, 0, 0, 0, mip.width, mip.height, mip.depth,
+                            GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+        }
+        else
+        {
+            glTexSubImage2D(target, level - newDropped, 0, 0, mip.width, mip.height,
+                            GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+        }
+        texels = {};
+    }
+
+    GLState::forgetTexture(old);
+    glDeleteTextures(1, &old);
+
+    *entry.owner = fresh;
+    entry.dropped = newDropped;
+    stats.current += residentBytes(entry);
+    stats.peak = std::max(stats.peak, stats.current);
+
+    node.key() = fresh;
+    textures.insert(std::move(node));
+}
@@ -0,0 +1,116 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_TEXTUREBUDGET_H
+#define LEARNOPENGL_TEXTUREBUDGET_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// keeps the video memory of Texture2D and TextureArray objects under a budget. textures that haven't been
+// used for a while lose their top mip levels: the levels are read back into a pixel pack buffer, and once
+// its fence signalled (a later frame, so the cpu never waits on the gpu) the texture is reallocated without
+// them. the dropped texels wait in system memory, until the texture is used again and gets them back on
+// the next update(). textures with a bindless handle are left alone, their storage can't change under the handle
+class TextureBudget
+{
+public:
+    struct Stats
+    {
+        // estimated bytes of tracked textures in video memory
+        std::size_t current = 0;
+        std::size_t peak = 0;
+        unsigned int trimmed = 0;
+        unsigned int restored = 0;
+    };
+
+    static Stats stats;
+
+    // bytes over which cold textures are trimmed, 0 for no limit
+    static std::size_t budget;
+
+    // frames a texture has to go unused to count as cold
+    static std::uint64_t coldFrames;
+
+    // starts tracking the texture with the name in id. reallocating it writes the new name to id,
+    // so id has to be the ID member of the texture object (moved along with move())
+    static void track(GLuint& id, GLenum target);
+
+    // call before deleting the texture
+    static void forget(GLuint id);
+
+    // the texture object owning id moved, newOwner is its ID member now
+    static void move(GLuint id, GLuint& newOwner);
+
+    // the texture is drawn with this frame. a trimmed one gets its mips back in the next update()
+    static void touch(GLuint id);
+
+    // call once per frame: restores used textures, finishes trims whose readback arrived, then starts
+    // reading back the coldest ones while over budget. at most maxChanges reallocations and readbacks
+    static void update(int maxChanges = 2);
+
+private:
+    // bases smaller than this aren't worth trimming further
+    static constexpr int MIN_SIZE = 32;
+
+    struct Level
+    {
+        int width;
+        int height;
+        // layers of an array texture
+        int depth;
+        std::size_t size;
+    };
+
+    struct Entry
+    {
+        GLuint* owner;
+        GLenum target;
+        GLenum internalFormat;
+        bool compressed;
+        // texels can be read back and uploaded again without loss
+        bool trimmable;
+
+        // every level the texture was created with
+        std::vector<Level> levels;
+
+        // top levels not in video memory right now, and their texels
+        int dropped = 0;
+        std::vector<std::vector<unsigned char>> droppedTexels;
+
+        std::uint64_t lastUsed = 0;
+        bool wanted = false;
+
+        // trim in flight: levels dropped..readbackDropped-1 are being copied into the readback buffer,
+        // one after the other, until the fence signals
+        GLuint readback = 0;
+        GLsync fence = nullptr;
+        int readbackDropped = 0;
+    };
+
+    static std::unordered_map<GLuint, Entry> textures;
+    static std::uint64_t frame;
+
+    [[nodiscard]] static std::size_t residentBytes(const Entry& entry);
+
+    // bytes a level takes in the readback buffer, rgba8 for uncompressed formats
+    [[nodiscard]] static std::size_t readbackBytes(const Entry& entry, int level);
+
+    // queues the readback of the levels a trim to newDropped drops
+    static void startTrim(Entry& entry, int newDropped);
+
+    // takes the texels out of the readback buffer once the fence signalled, false while it hasn't
+    static bool finishReadback(Entry& entry);
+    static void cancelReadback(Entry& entry);
+
+    // reallocates the texture with its first newDropped levels in system memory, which must be in
+    // droppedTexels already for levels it didn't drop before
+    static void reallocate(GLuint id, int newDropped);
+};
+
+#endif //LEARNOPENGL_TEXTUREBUDGET_H
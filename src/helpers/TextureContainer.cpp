@@ -0,0 +1,315 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "TextureContainer.h"
+#include "GLExtensions.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+// little endian value at offset, the caller checked it is in range
+template<typename T>
+static T read(const std::vector<unsigned char>& data, std::size_t offset)
+{
+    T value;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+
+static constexpr std::uint32_t fourCC(const char (&code)[5])
+{
+    return std::uint32_t(code[0]) | std::uint32_t(code[1]) << 8 | std::uint32_t(code[2]) << 16
+            | std::uint32_t(code[3]) << 24;
+}
+
+static std::string lowercaseExtension(const std::string& path)
+{
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extension;
+}
+
+// larger than any driver's GL_MAX_TEXTURE_SIZE, keeps the level math in int and size_t
+static constexpr std::uint32_t MAX_DIMENSION = 1 << 16;
+
+// levels from width x height down to 1x1, the most a file can hold
+static std::uint32_t fullMipChain(std::uint32_t width, std::uint32_t height)
+{
+    std::uint32_t levels = 1;
+    for(std::uint32_t size = std::max(width, height); size > 1; size /= 2)
+    {
+        levels++;
+    }
+    return levels;
+}
+
+static bool validDimensions(std::uint32_t width, std::uint32_t height)
+{
+    return width > 0 && height > 0 && width <= MAX_DIMENSION && height <= MAX_DIMENSION;
+}
+
+// BC1 and BC3 come from an extension, everything else we load is core
+static bool isS3tc(GLenum format)
+{
+    switch(format)
+    {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT: case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT: case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT: case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool TextureContainer::isContainer(const std::string& path)
+{
+    std::string extension = lowercaseExtension(path);
+    return extension == ".ktx2" || extension == ".dds";
+}
+
+bool TextureContainer::load(const std::string& path, TextureImage& image)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file)
+    {
+        std::cout << "ERROR::TEXTURE::FILE_NOT_READ " << path << '\n';
+        return false;
+    }
+    return parse(path, std::vector<unsigned char>(std::istreambuf_iterator<char>(file), {}), image);
+}
+
+bool TextureContainer::parse(const std::string& path, std::vector<unsigned char> bytes, TextureImage& image)
+{
+    image.data = std::move(bytes);
+
+    bool parsed = lowercaseExtension(path) == ".dds" ? parseDds(path, image) : parseKtx2(path, image);
+    if(!parsed)
+    {
+        return false;
+    }
+
+    if(isS3tc(image.internalFormat) && !GLExtensions::s3tc)
+    {
+        std::cout << "ERROR::TEXTURE::S3TC_NOT_SUPPORTED " << path << '\n';
+        return false;
+    }
+    return true;
+}
+
+void TextureContainer::upload(const TextureImage& image, const unsigned char* data)
+{
+    // truncated chains are fine, immutable storage only has the levels it was allocated with
+    glTexStorage2D(GL_TEXTURE_2D, (GLsizei) image.levels.size(), image.internalFormat, image.levels[0].width,
+                   image.levels[0].height);
+
+    for(std::size_t level = 0; level < image.levels.size(); level++)
+    {
+        const TextureImage::Level& mip = image.levels[level];
+        if(image.compressed)
+        {
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, (GLint) level, 0, 0, mip.width, mip.height, image.internalFormat,
+                                      (GLsizei) mip.size, data + mip.offset);
+        }
+        else
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, (GLint) level, 0, 0, mip.width, mip.height, GL_RGBA, GL_UNSIGNED_BYTE,
+                            data + mip.offset);
+        }
+    }
+}
+
+std::size_t TextureContainer::blockBytes(GLenum format)
+{
+    switch(format)
+    {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT: case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT: case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+            return 8;
+        default:
+            return 16;
+    }
+}
+
+GLenum TextureContainer::fromVkFormat(unsigned int format, int& numChannels)
+{
+    switch(format)
+    {
+        case 37: numChannels = 4; return GL_RGBA8;                                // R8G8B8A8_UNORM
+        case 43: numChannels = 4; return GL_SRGB8_ALPHA8;                         // R8G8B8A8_SRGB
+        case 131: numChannels = 3; return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;        // BC1_RGB_UNORM
+        case 132: numChannels = 3; return GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;       // BC1_RGB_SRGB
+        case 133: numChannels = 4; return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;       // BC1_RGBA_UNORM
+        case 134: numChannels = 4; return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT; // BC1_RGBA_SRGB
+        case 137: numChannels = 4; return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;       // BC3_UNORM
+        case 138: numChannels = 4; return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT; // BC3_SRGB
+        case 141: numChannels = 2; return GL_COMPRESSED_RG_RGTC2;                 // BC5_UNORM
+        case 142: numChannels = 2; return GL_COMPRESSED_SIGNED_RG_RGTC2;          // BC5_SNORM
+        case 145: numChannels = 4; return GL_COMPRESSED_RGBA_BPTC_UNORM;          // BC7_UNORM
+        case 146: numChannels = 4; return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;    // BC7_SRGB
+        default: return 0;
+    }
+}
+
+GLenum TextureContainer::fromDxgiFormat(unsigned int format, int& numChannels)
+{
+    switch(format)
+    {
+        case 71: numChannels = 4; return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;       // BC1_UNORM
+        case 72: numChannels = 4; return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT; // BC1_UNORM_SRGB
+        case 77: numChannels = 4; return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;       // BC3_UNORM
+        case 78: numChannels = 4; return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT; // BC3_UNORM_SRGB
+        case 83: numChannels = 2; return GL_COMPRESSED_RG_RGTC2;                 // BC5_UNORM
+        case 84: numChannels = 2; return GL_COMPRESSED_SIGNED_RG_RGTC2;          // BC5_SNORM
+        case 98: numChannels = 4; return GL_COMPRESSED_RGBA_BPTC_UNORM;          // BC7_UNORM
+        case 99: numChannels = 4; return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;    // BC7_UNORM_SRGB
+        default: return 0;
+    }
+}
+
+bool TextureContainer::packedLevels(TextureImage& image, int width, int height, int count, std::size_t offset)
+{
+    std::size_t block = blockBytes(image.internalFormat);
+    for(int level = 0; level < count; level++)
+    {
+        std::size_t size = std::size_t(std::max(1, (width + 3) / 4)) * std::max(1, (height + 3) / 4) * block;
+        if(offset + size > image.data.size())
+        {
+            return false;
+        }
+        image.levels.push_back({width, height, offset, size});
+
+        offset += size;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    return true;
+}
+
+bool TextureContainer::parseKtx2(const std::string& path, TextureImage& image)
+{
+    static const unsigned char identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    // identifier, 9 header fields, dfd/kvd/sgd index
+    constexpr std::size_t headerSize = 12 + 9 * 4 + 4 * 4 + 2 * 8;
+    if(image.data.size() < headerSize || std::memcmp(image.data.data(), identifier, sizeof(identifier)) != 0)
+    {
+        std::cout << "ERROR::TEXTURE::NOT_KTX2 " << path << '\n';
+        return false;
+    }
+
+    auto vkFormat = read<std::uint32_t>(image.data, 12);
+    auto width = read<std::uint32_t>(image.data, 20);
+    auto height = read<std::uint32_t>(image.data, 24);
+    auto depth = read<std::uint32_t>(image.data, 28);
+    auto layerCount = read<std::uint32_t>(image.data, 32);
+    auto faceCount = read<std::uint32_t>(image.data, 36);
+    auto levelCount = std::max(1u, read<std::uint32_t>(image.data, 40));
+    auto supercompression = read<std::uint32_t>(image.data, 44);
+
+    image.internalFormat = fromVkFormat(vkFormat, image.numChannels);
+    image.compressed = image.internalFormat != GL_RGBA8 && image.internalFormat != GL_SRGB8_ALPHA8;
+    if(!image.internalFormat || depth > 1 || layerCount > 1 || faceCount != 1 || supercompression != 0)
+    {
+        std::cout << "ERROR::TEXTURE::UNSUPPORTED_KTX2 " << path << " (vkFormat " << vkFormat
+                  << ", only 2D BC1/BC3/BC5/BC7/RGBA8 without supercompression)\n";
+        return false;
+    }
+
+    if(!validDimensions(width, height) || levelCount > fullMipChain(width, height))
+    {
+        std::cout << "ERROR::TEXTURE::BAD_DIMENSIONS " << path << " (" << width << "x" << height << ", "
+                  << levelCount << " levels)\n";
+        return false;
+    }
+
+    // level index right after the header: byteOffset, byteLength, uncompressedByteLength
+    if(image.data.size() < headerSize + std::size_t(levelCount) * 24)
+    {
+        std::cout << "ERROR::TEXTURE::TRUNCATED " << path << '\n';
+        return false;
+    }
+
+    for(std::uint32_t level = 0; level < levelCount; level++)
+    {
+        std::size_t entry = headerSize + std::size_t(level) * 24;
+        auto offset = read<std::uint64_t>(image.data, entry);
+        auto size = read<std::uint64_t>(image.data, entry + 8);
+        if(offset > image.data.size() || size > image.data.size() - offset)
+        {
+            std::cout << "ERROR::TEXTURE::TRUNCATED " << path << '\n';
+            return false;
+        }
+
+        // level < fullMipChain, so the shifts stay below 32
+        image.levels.push_back({int(std::max(1u, width >> level)), int(std::max(1u, height >> level)),
+                                std::size_t(offset), std::size_t(size)});
+    }
+    return true;
+}
+
+bool TextureContainer::parseDds(const std::string& path, TextureImage& image)
+{
+    // magic, DDS_HEADER
+    constexpr std::size_t headerSize = 4 + 124;
+    if(image.data.size() < headerSize || read<std::uint32_t>(image.data, 0) != fourCC("DDS "))
+    {
+        std::cout << "ERROR::TEXTURE::NOT_DDS " << path << '\n';
+        return false;
+    }
+
+    auto height = read<std::uint32_t>(image.data, 12);
+    auto width = read<std::uint32_t>(image.data, 16);
+    auto levelCount = std::max(1u, read<std::uint32_t>(image.data, 28));
+    auto format = read<std::uint32_t>(image.data, 84);
+
+    if(!validDimensions(width, height) || levelCount > fullMipChain(width, height))
+    {
+        std::cout << "ERROR::TEXTURE::BAD_DIMENSIONS " << path << " (" << width << "x" << height << ", "
+                  << levelCount << " levels)\n";
+        return false;
+    }
+
+    std::size_t offset = headerSize;
+    if(format == fourCC("DXT1"))
+    {
+        image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        image.numChannels = 4;
+    }
+    else if(format == fourCC("DXT5"))
+    {
+        image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        image.numChannels = 4;
+    }
+    else if(format == fourCC("ATI2") || format == fourCC("BC5U"))
+    {
+        image.internalFormat = GL_COMPRESSED_RG_RGTC2;
+        image.numChannels = 2;
+    }
+    // DX10 extension header follows, it holds the real format
+    else if(format == fourCC("DX10") && image.data.size() >= headerSize + 20)
+    {
+        image.internalFormat = fromDxgiFormat(read<std::uint32_t>(image.data, headerSize), image.numChannels);
+        offset += 20;
+    }
+
+    if(!image.internalFormat)
+    {
+        std::cout << "ERROR::TEXTURE::UNSUPPORTED_DDS " << path << " (only BC1/BC3/BC5/BC7)\n";
+        return false;
+    }
+
+    if(!packedLevels(image, int(width), int(height), int(levelCount), offset))
+    {
+        std::cout << "ERROR::TEXTURE::TRUNCATED " << path << '\n';
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_TEXTURECONTAINER_H
+#define LEARNOPENGL_TEXTURECONTAINER_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// image and its mip chain as stored in a KTX2 or DDS file, block compressed or plain RGBA8
+struct TextureImage
+{
+    struct Level
+    {
+        int width;
+        int height;
+
+        // where the level's texels/blocks are in data
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    GLenum internalFormat = 0;
+    int numChannels = 0;
+
+    // uploaded with glCompressedTexSubImage2D, else glTexSubImage2D from GL_RGBA/GL_UNSIGNED_BYTE
+    bool compressed = true;
+
+    // largest level first
+    std::vector<Level> levels;
+    std::vector<unsigned char> data;
+};
+
+// reads KTX2 and DDS files holding BC1, BC3, BC5 or BC7 data, uploaded with glCompressedTexSubImage2D
+// without decoding. KTX2 can also hold RGBA8 (what texture_baker writes without --bc). rows are uploaded in the order they are stored, bottom row first like OpenGL
+// expects (texture_baker writes them that way)
+class TextureContainer
+{
+public:
+    // .ktx2 and .dds paths, everything else goes through stb_image
+    static bool isContainer(const std::string& path);
+
+    // false (with a message) if the file can't be read or holds a format we can't upload
+    static bool load(const std::string& path, TextureImage& image);
+
+    // the same for the bytes of a file that was already read, path picks the format and names it in messages
+    static bool parse(const std::string& path, std::vector<unsigned char> bytes, TextureImage& image);
+
+    // allocates immutable storage for every level of the texture bound to GL_TEXTURE_2D and fills it.
+    // data is image.data, or its offset in the bound pixel unpack buffer
+    static void upload(const TextureImage& image, const unsigned char* data);
+
+private:
+    static bool parseKtx2(const std::string& path, TextureImage& image);
+    static bool parseDds(const std::string& path, TextureImage& image);
+
+    // GL format (and channel count) of a KTX2 VkFormat / DDS DXGI_FORMAT, 0 if unsupported.
+    // only block compressed formats from DDS
+    static GLenum fromVkFormat(unsigned int format, int& numChannels);
+    static GLenum fromDxgiFormat(unsigned int format, int& numChannels);
+
+    static std::size_t blockBytes(GLenum format);
+
+    // levels packed one after the other from offset, like DDS stores them
+    static bool packedLevels(TextureImage& image, int width, int height, int count, std::size_t offset);
+};
+
+#endif //LEARNOPENGL_TEXTURECONTAINER_H
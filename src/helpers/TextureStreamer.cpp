@@ -0,0 +1,509 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "TextureStreamer.h"
+#include "GLState.h"
+#include "TextureBudget.h"
+
+#include <cstring>
+#include <iterator>
+
+// ring allocations start on this boundary
+static constexpr std::size_t UPLOAD_ALIGNMENT = 256;
+
+std::unordered_map<GLuint, TextureStreamer::Target> TextureStreamer::targets;
+
+TextureStreamer::TextureStreamer(std::size_t ringSize, unsigned int workerCount)
+        : ringSize(ringSize), running(true), pending(0)
+{
+    // mapped once for the streamer's lifetime, coherent so copies need no flush
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr) ringSize, nullptr, flags);
+    mapped = (unsigned char*) glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr) ringSize, flags);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if(!mapped)
+    {
+        std::cout << "ERROR::TEXTURE_STREAMER::MAP_FAILED, uploading from memory\n";
+    }
+
+    for(unsigned int i = 0; i < workerCount; i++)
+    {
+        workers.emplace_back(&TextureStreamer::work, this);
+    }
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    jobAdded.notify_all();
+    for(std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    // textures still waiting keep their placeholder
+    for(const Job& job : jobs)
+    {
+        targets.erase(job.placeholder);
+    }
+    for(std::deque<Decoded>* queue : {&decoded, &ready})
+    {
+        for(Decoded& image : *queue)
+        {
+            targets.erase(image.job.placeholder);
+            stbi_image_free(image.pixels);
+            if(image.arrayID)
+            {
+                GLState::forgetTexture(image.arrayID);
+                glDeleteTextures(1, &image.arrayID);
+            }
+        }
+    }
+
+    for(Upload& upload : uploads)
+    {
+        targets.erase(upload.placeholder);
+        glDeleteSync(upload.fence);
+        if(upload.complete)
+        {
+            GLState::forgetTexture(upload.ID);
+            glDeleteTextures(1, &upload.ID);
+        }
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(1, &buffer);
+}
+
+void TextureStreamer::load(Texture2D& texture, const char* texturePath, bool generateMipMaps)
+{
+    // 1x1 grey, same as the fallback shader draws. the texture owns it like any other texture object,
+    // its name is what the job finds the texture by
+    const unsigned char grey[4] = {128, 128, 128, 255};
+    texture.release();
+    glGenTextures(1, &texture.ID);
+    GLState::bindTexture(GL_TEXTURE_2D, texture.ID);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, 1, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, grey);
+
+    texture.width = 1;
+    texture.height = 1;
+    texture.numChannels = 4;
+    targets[texture.ID] = {&texture, nullptr};
+
+    pending++;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back({texture.ID, {texturePath}, generateMipMaps, false});
+    }
+    jobAdded.notify_one();
+}
+
+void TextureStreamer::load(TextureArray& array, const std::vector<std::string>& paths)
+{
+    // a grey layer like the Texture2D placeholder, every map is all of it until the real layout arrives
+    const unsigned char grey[4] = {128, 128, 128, 255};
+    array.release();
+    if(paths.empty())
+    {
+        return;
+    }
+    glGenTextures(1, &array.ID);
+    GLState::bindTexture(GL_TEXTURE_2D_ARRAY, array.ID);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, 1, 1, 1);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, 1, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, grey);
+
+    array.width = 1;
+    array.height = 1;
+    array.layers = 1;
+    array.regions.assign(paths.size(), {0, {0, 0, 1, 1}});
+    targets[array.ID] = {nullptr, &array};
+
+    pending++;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back({array.ID, paths, true, true});
+    }
+    jobAdded.notify_one();
+}
+
+void TextureStreamer::move(GLuint placeholder, Texture2D& newOwner)
+{
+    auto found = targets.find(placeholder);
+    if(found != targets.end())
+    {
+        found->second = {&newOwner, nullptr};
+    }
+}
+
+void TextureStreamer::move(GLuint placeholder, TextureArray& newOwner)
+{
+    auto found = targets.find(placeholder);
+    if(found != targets.end())
+    {
+        found->second = {nullptr, &newOwner};
+    }
+}
+
+void TextureStreamer::forget(GLuint placeholder)
+{
+    targets.erase(placeholder);
+}
+
+bool TextureStreamer::idle() const
+{
+    return pending == 0;
+}
+
+void TextureStreamer::work()
+{
+    while(true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAdded.wait(lock, [this] { return !running || !jobs.empty(); });
+            if(!running)
+            {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        Decoded image {job, nullptr, 0, 0, 0, {}};
+        const std::string& path = job.paths[0];
+        bool loaded;
+
+        // decoded and packed like TextureArray does it, which reports the maps it couldn't load
+        if(job.array)
+        {
+            loaded = TextureArray::prepare(job.paths, image.arrayImage);
+            if(!loaded)
+            {
+                pending--;
+                continue;
+            }
+        }
+        // containers are only read, their blocks go to the gpu as they are
+        else if(TextureContainer::isContainer(path))
+        {
+            loaded = TextureContainer::load(path, image.container);
+            if(loaded)
+            {
+                image.width = image.container.levels[0].width;
+                image.height = image.container.levels[0].height;
+                image.numChannels = image.container.numChannels;
+            }
+        }
+        else
+        {
+            // stb_image is reentrant, the flip flag set at startup is read by every thread
+            image.pixels = stbi_load(path.c_str(), &image.width, &image.height, &image.numChannels, 0);
+            loaded = image.pixels && (image.numChannels == 3 || image.numChannels == 4);
+        }
+
+        if(!loaded)
+        {
+            std::cout << "texture " << path << " did not load correctly!\n";
+            stbi_image_free(image.pixels);
+            pending--;
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        decoded.push_back(std::move(image));
+    }
+}
+
+std::size_t TextureStreamer::allocate(std::size_t size)
+{
+    size = (size + UPLOAD_ALIGNMENT - 1) / UPLOAD_ALIGNMENT * UPLOAD_ALIGNMENT;
+    if(size > ringSize)
+    {
+        return ringSize;
+    }
+
+    if(uploads.empty())
+    {
+        head = 0;
+    }
+
+    // oldest region the gpu may still read. head == tail only ever means empty
+    std::size_t tail = uploads.empty() ? head : uploads.front().begin;
+
+    std::size_t offset = ringSize;
+    if(head >= tail)
+    {
+        if(head + size <= ringSize)
+        {
+            offset = head;
+        }
+        // wrap around, the rest of the end is skipped
+        else if(size < tail)
+        {
+            offset = 0;
+        }
+    }
+    else if(head + size < tail)
+    {
+        offset = head;
+    }
+
+    if(offset != ringSize)
+    {
+        head = offset + size;
+    }
+    return offset;
+}
+
+std::size_t TextureStreamer::Decoded::size() const
+{
+    if(job.array)
+    {
+        return arrayImage.data.size();
+    }
+    return fromContainer() ? container.data.size() : (std::size_t) width * height * numChannels;
+}
+
+GLuint TextureStreamer::createTexture(const Decoded& image, const void* pixels)
+{
+    GLuint ID;
+    glGenTextures(1, &ID);
+    GLState::bindTexture(GL_TEXTURE_2D, ID);
+
+    if(image.fromContainer())
+    {
+        TextureContainer::upload(image.container, (const unsigned char*) pixels);
+        return ID;
+    }
+
+    GLsizei levels = image.job.generateMipMaps ? Texture2D::mipLevels(image.width, image.height) : 1;
+    glTexStorage2D(GL_TEXTURE_2D, levels, Texture2D::sizedFormat(image.numChannels), image.width, image.height);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.width, image.height, Texture2D::pixelFormat(image.numChannels),
+                    GL_UNSIGNED_BYTE, pixels);
+    if(image.job.generateMipMaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    return ID;
+}
+
+void TextureStreamer::swapIn(Upload& upload)
+{
+    auto found = targets.find(upload.placeholder);
+    if(found == targets.end())
+    {
+        GLState::forgetTexture(upload.ID);
+        glDeleteTextures(1, &upload.ID);
+        return;
+    }
+
+    // drops the placeholder, which forgets the target
+    Target target = found->second;
+    if(target.array)
+    {
+        TextureArray& array = *target.array;
+        array.release();
+        array.ID = upload.ID;
+        array.width = upload.width;
+        array.height = upload.height;
+        array.layers = upload.layers;
+        array.regions = std::move(upload.regions);
+        TextureBudget::track(array.ID, GL_TEXTURE_2D_ARRAY);
+        return;
+    }
+
+    Texture2D& texture = *target.texture;
+    texture.release();
+    texture.ID = upload.ID;
+    texture.width = upload.width;
+    texture.height = upload.height;
+    texture.numChannels = upload.numChannels;
+    TextureBudget::track(texture.ID, GL_TEXTURE_2D);
+}
+
+bool TextureStreamer::uploadArray(Decoded& image, std::size_t byteBudget)
+{
+    const TextureArray::Image& array = image.arrayImage;
+    if(image.arrayID == 0)
+    {
+        image.arrayID = TextureArray::allocate(array);
+    }
+    GLState::bindTexture(GL_TEXTURE_2D_ARRAY, image.arrayID);
+
+    while(image.slicesUploaded < array.slices.size())
+    {
+        const TextureArray::Image::Slice& slice = array.slices[image.slicesUploaded];
+        if(uploadedBytes > 0 && uploadedBytes + slice.size > byteBudget)
+        {
+            return false;
+        }
+
+        bool direct = !mapped || slice.size + UPLOAD_ALIGNMENT > ringSize;
+        std::size_t offset = direct ? ringSize : allocate(slice.size);
+        if(!direct && offset == ringSize)
+        {
+            return false;
+        }
+
+        if(direct)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            TextureArray::upload(array, slice, array.data.data() + slice.offset);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        }
+        else
+        {
+            std::memcpy(mapped + offset, array.data.data() + slice.offset, slice.size);
+            TextureArray::upload(array, slice, (const void*) offset);
+        }
+
+        uploadedBytes += slice.size;
+        bool last = ++image.slicesUploaded == array.slices.size();
+        if(last)
+        {
+            TextureArray::finish(array);
+        }
+
+        // the last slice's fence also covers the mips, it swaps the array in. the others only free their
+        // part of the ring. a direct last slice swaps in right away, the gl orders draws after the uploads
+        Upload upload {image.job.placeholder, last ? image.arrayID : 0, array.width, array.height, 4, nullptr,
+                       direct ? head : offset, head, last, array.layers};
+        if(last)
+        {
+            upload.regions = array.regions;
+        }
+
+        if(direct && last)
+        {
+            swapIn(upload);
+            pending--;
+        }
+        else if(!direct)
+        {
+            upload.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            uploads.push_back(std::move(upload));
+        }
+    }
+    return true;
+}
+
+void TextureStreamer::update(std::size_t byteBudget)
+{
+    // swap in finished uploads, in order since their ring regions are freed in order
+    while(!uploads.empty())
+    {
+        Upload& upload = uploads.front();
+        if(glClientWaitSync(upload.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+        {
+            break;
+        }
+
+        glDeleteSync(upload.fence);
+        if(upload.complete)
+        {
+            swapIn(upload);
+            pending--;
+        }
+        uploads.pop_front();
+    }
+
+    uploadedBytes = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::move(decoded.begin(), decoded.end(), std::back_inserter(ready));
+        decoded.clear();
+    }
+
+    if(ready.empty())
+    {
+        return;
+    }
+
+    // rows of rgb images aren't 4 byte aligned in general
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+
+    while(!ready.empty())
+    {
+        Decoded& image = ready.front();
+        std::size_t size = image.size();
+
+        // the texture went away while its file was decoding (or its slices uploading)
+        if(!targets.contains(image.job.placeholder))
+        {
+            stbi_image_free(image.pixels);
+            if(image.arrayID)
+            {
+                GLState::forgetTexture(image.arrayID);
+                glDeleteTextures(1, &image.arrayID);
+            }
+            ready.pop_front();
+            pending--;
+            continue;
+        }
+
+        // a slice at a time, an array that doesn't fit this frame carries on in the next one
+        if(image.job.array)
+        {
+            if(!uploadArray(image, byteBudget))
+            {
+                break;
+            }
+            ready.pop_front();
+            continue;
+        }
+
+        if(uploadedBytes > 0 && uploadedBytes + size > byteBudget)
+        {
+            break;
+        }
+
+        // doesn't fit the ring at all: upload from memory. the name can be swapped in right away,
+        // glTexSubImage2D copied the pixels before returning
+        bool direct = !mapped || size + UPLOAD_ALIGNMENT > ringSize;
+        std::size_t offset = direct ? ringSize : allocate(size);
+
+        if(direct)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            Upload upload {image.job.placeholder, createTexture(image, image.bytes()), image.width, image.height,
+                           image.numChannels, nullptr, 0, 0};
+            swapIn(upload);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+            pending--;
+        }
+        // the gpu is still reading the space we'd need, next frame
+        else if(offset == ringSize)
+        {
+            break;
+        }
+        else
+        {
+            std::memcpy(mapped + offset, image.bytes(), size);
+
+            Upload upload {image.job.placeholder, 0, image.width, image.height, image.numChannels, nullptr, offset, head};
+            upload.ID = createTexture(image, (const void*) offset);
+            upload.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            uploads.push_back(upload);
+        }
+
+        uploadedBytes += size;
+        stbi_image_free(image.pixels);
+        ready.pop_front();
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
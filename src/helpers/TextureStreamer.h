@@ -0,0 +1,157 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_TEXTURESTREAMER_H
+#define LEARNOPENGL_TEXTURESTREAMER_H
+
+#include "Texture2D.h"
+#include "TextureArray.h"
+#include "TextureContainer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// loads textures without blocking the render thread: images are decoded on worker threads,
+// copied into a persistently mapped pixel unpack buffer and uploaded from there a few per frame.
+// array textures are laid out by the workers too and uploaded a slice (a level of a layer) at a time.
+// a streamed texture shows a placeholder of its own until its upload has completed on the gpu
+class TextureStreamer
+{
+public:
+    // ringSize bytes of upload buffer, images bigger than that are uploaded straight from memory
+    explicit TextureStreamer(std::size_t ringSize = 16 * 1024 * 1024,
+                             unsigned int workerCount = std::max(1u, std::thread::hardware_concurrency() / 2));
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // points texture at the placeholder right away and queues the file for decoding. the texture can be
+    // moved or deleted before it arrives, the load follows it or is dropped
+    void load(Texture2D& texture, const char* texturePath, bool generateMipMaps = true);
+
+    // the same for the maps of an array texture. until they arrive it is a single grey layer,
+    // and every region is that whole layer
+    void load(TextureArray& array, const std::vector<std::string>& paths);
+
+    // the texture object owning a placeholder moved, or deleted it (its load is dropped).
+    // Texture2D and TextureArray call these
+    static void move(GLuint placeholder, Texture2D& newOwner);
+    static void move(GLuint placeholder, TextureArray& newOwner);
+    static void forget(GLuint placeholder);
+
+    // call once per frame on the GL thread. swaps in textures whose upload finished, then uploads
+    // decoded images until byteBudget bytes were copied (at least one image, so big ones get through)
+    void update(std::size_t byteBudget);
+
+    // nothing queued, decoding or uploading
+    [[nodiscard]] bool idle() const;
+
+    // bytes copied to the upload buffer by the last update()
+    std::size_t uploadedBytes = 0;
+
+private:
+    // what a placeholder stands in for, one of the two
+    struct Target
+    {
+        Texture2D* texture = nullptr;
+        TextureArray* array = nullptr;
+    };
+
+    struct Job
+    {
+        // the placeholder's name, the texture is looked up in targets when its upload lands
+        GLuint placeholder;
+        // one path, or the maps of an array
+        std::vector<std::string> paths;
+        bool generateMipMaps;
+        bool array;
+    };
+
+    // stb pixels, or the file's levels when it is a KTX2/DDS container, or the laid out maps of an array
+    struct Decoded
+    {
+        Job job;
+        unsigned char* pixels;
+        int width;
+        int height;
+        int numChannels;
+        TextureImage container;
+
+        // the array's texture object once its first slice went up, and the slices uploaded so far
+        TextureArray::Image arrayImage;
+        GLuint arrayID = 0;
+        std::size_t slicesUploaded = 0;
+
+        [[nodiscard]] bool fromContainer() const { return container.internalFormat != 0; }
+        [[nodiscard]] const unsigned char* bytes() const { return fromContainer() ? container.data.data() : pixels; }
+        [[nodiscard]] std::size_t size() const;
+    };
+
+    // texture uploaded into a new name, swapped in when its fence signals
+    struct Upload
+    {
+        GLuint placeholder;
+        GLuint ID;
+        int width;
+        int height;
+        int numChannels;
+        GLsync fence;
+
+        // part of the ring it was copied from, free again once the fence signaled
+        std::size_t begin;
+        std::size_t end;
+
+        // false for an array's slices before the last one, they only give back their part of the ring (ID is 0)
+        bool complete = true;
+        int layers = 1;
+        std::vector<TextureArray::Region> regions;
+    };
+
+    // streamed textures by the name of their placeholder, only touched on the GL thread
+    static std::unordered_map<GLuint, Target> targets;
+
+    GLuint buffer = 0;
+    unsigned char* mapped = nullptr;
+    std::size_t ringSize;
+    std::size_t head = 0;
+    std::deque<Upload> uploads;
+
+    std::vector<std::thread> workers;
+    std::atomic<bool> running;
+    std::atomic<unsigned int> pending;
+
+    std::mutex mutex;
+    std::condition_variable jobAdded;
+    std::deque<Job> jobs;
+    std::deque<Decoded> decoded;
+
+    // decoded images taken over by the GL thread, waiting for budget or ring space
+    std::deque<Decoded> ready;
+
+    void work();
+
+    // offset of size free bytes in the ring, or ringSize if the gpu still reads from there
+    std::size_t allocate(std::size_t size);
+
+    // uploads slices of the array until the budget or the ring runs out, true once the last one went
+    bool uploadArray(Decoded& image, std::size_t byteBudget);
+
+    // new texture object with image's pixels (or blocks), read from the bound unpack buffer at pixels
+    static GLuint createTexture(const Decoded& image, const void* pixels);
+
+    // gives the texture the new name in place of its placeholder, and hands it to TextureBudget.
+    // the new name is deleted if the texture is gone
+    static void swapIn(Upload& upload);
+};
+
+#endif //LEARNOPENGL_TEXTURESTREAMER_H
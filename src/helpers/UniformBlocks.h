@@ -0,0 +1,31 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_UNIFORMBLOCKS_H
+#define LEARNOPENGL_UNIFORMBLOCKS_H
+
+#include <glad/glad.h>
+
+// std140 mirrors of the uniform blocks in shaders/, generated at build time by uniform_reflect
+#include "ShaderBlocks.h"
+
+using glsl::FrameData;
+using glsl::MaterialData;
+using glsl::VirtualTextureData;
+
+struct UniformBlockInfo
+{
+    const char* name;
+    GLuint binding;
+};
+
+// Shader attaches any block with one of these names to its binding point after linking,
+// which covers programs whose source doesn't give the block a binding
+inline constexpr UniformBlockInfo UNIFORM_BLOCKS[] = {
+        {FrameData::blockName, FrameData::binding},
+        {MaterialData::blockName, MaterialData::binding},
+        {VirtualTextureData::blockName, VirtualTextureData::binding}
+};
+
+#endif //LEARNOPENGL_UNIFORMBLOCKS_H
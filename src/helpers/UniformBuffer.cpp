@@ -0,0 +1,24 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "UniformBuffer.h"
+
+UniformBuffer::UniformBuffer(GLuint binding, GLsizeiptr size) : binding(binding), size(size)
+{
+    glGenBuffers(1, &ID);
+    glBindBuffer(GL_UNIFORM_BUFFER, ID);
+
+    // contents change every frame
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, ID);
+}
+
+void UniformBuffer::update(const void* data, GLsizeiptr dataSize, GLintptr offset) const
+{
+    glBindBuffer(GL_UNIFORM_BUFFER, ID);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, dataSize, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,30 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_UNIFORMBUFFER_H
+#define LEARNOPENGL_UNIFORMBUFFER_H
+
+#include <glad/glad.h>
+
+class UniformBuffer
+{
+public:
+    GLuint ID;
+    GLuint binding;
+    GLsizeiptr size;
+
+    // allocates the buffer and keeps it bound to binding, so programs only need their block attached
+    UniformBuffer(GLuint binding, GLsizeiptr size);
+
+    void update(const void* data, GLsizeiptr dataSize, GLintptr offset = 0) const;
+
+    // uploads a whole std140 mirror struct at once
+    template<typename T>
+    void update(const T& data) const
+    {
+        update(&data, sizeof(T));
+    }
+};
+
+#endif //LEARNOPENGL_UNIFORMBUFFER_H
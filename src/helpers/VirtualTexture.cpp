@@ -0,0 +1,515 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#include "VirtualTexture.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+#include "SamplerCache.h"
+
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iostream>
+
+// bilinear, for sources that aren't powers of two
+static std::vector<unsigned char> resample(const unsigned char* pixels, int sourceWidth, int sourceHeight,
+                                           int width, int height)
+{
+    std::vector<unsigned char> texels((std::size_t) width * height * 4);
+    for(int y = 0; y < height; y++)
+    {
+        float sourceY = std::max(((float) y + 0.5f) * (float) sourceHeight / (float) height - 0.5f, 0.0f);
+        int y0 = std::min((int) sourceY, sourceHeight - 1);
+        int y1 = std::min(y0 + 1, sourceHeight - 1);
+        float fy = sourceY - (float) y0;
+
+        for(int x = 0; x < width; x++)
+        {
+            float sourceX = std::max(((float) x + 0.5f) * (float) sourceWidth / (float) width - 0.5f, 0.0f);
+            int x0 = std::min((int) sourceX, sourceWidth - 1);
+            int x1 = std::min(x0 + 1, sourceWidth - 1);
+            float fx = sourceX - (float) x0;
+
+            for(int c = 0; c < 4; c++)
+            {
+                auto texel = [&](int sx, int sy)
+                {
+                    return (float) pixels[((std::size_t) sy * sourceWidth + sx) * 4 + c];
+                };
+                float top = texel(x0, y0) + (texel(x1, y0) - texel(x0, y0)) * fx;
+                float bottom = texel(x0, y1) + (texel(x1, y1) - texel(x0, y1)) * fx;
+                texels[((std::size_t) y * width + x) * 4 + c] = (unsigned char) std::lround(top + (bottom - top) * fy);
+            }
+        }
+    }
+    return texels;
+}
+
+// 2x2 box filter, sides that are already 1 texel stay 1
+static std::vector<unsigned char> downsample(const std::vector<unsigned char>& texels, int width, int height)
+{
+    int halfWidth = std::max(width / 2, 1);
+    int halfHeight = std::max(height / 2, 1);
+    std::vector<unsigned char> half((std::size_t) halfWidth * halfHeight * 4);
+
+    for(int y = 0; y < halfHeight; y++)
+    {
+        int y0 = std::min(y * 2, height - 1);
+        int y1 = std::min(y * 2 + 1, height - 1);
+        for(int x = 0; x < halfWidth; x++)
+        {
+            int x0 = std::min(x * 2, width - 1);
+            int x1 = std::min(x * 2 + 1, width - 1);
+            for(int c = 0; c < 4; c++)
+            {
+                auto texel = [&](int sx, int sy) { return (int) texels[((std::size_t) sy * width + sx) * 4 + c]; };
+                int sum = texel(x0, y0) + texel(x1, y0) + texel(x0, y1) + texel(x1, y1);
+                half[((std::size_t) y * halfWidth + x) * 4 + c] = (unsigned char) ((sum + 2) / 4);
+            }
+        }
+    }
+    return half;
+}
+
+VirtualTexture::VirtualTexture(const std::string& path, int maxResidentPages)
+    : pageTable(0), pageStorage(0), sparse(false), width(0), height(0), pageSize(PAGE_SIZE), pageLevels(0),
+      residentPages(0), maxResidentPages(maxResidentPages)
+{
+    GLint sparseIndex = -1;
+    if(GLExtensions::sparseTexture)
+    {
+        sparseIndex = sparsePageSizeIndex(pageSize);
+    }
+
+    if(!load(path))
+    {
+        std::cout << "virtual texture " << path << " did not load correctly!\n";
+        return;
+    }
+
+    int sparseLevels = sparseIndex >= 0 ? createSparse(sparseIndex) : 0;
+    sparse = sparseLevels > 0;
+
+    createPages(sparse ? sparseLevels : (int) levels.size());
+    if(!sparse)
+    {
+        createCache();
+    }
+    createPageTable();
+
+    // the coarsest page level is what everything falls back to
+    const Level& coarsest = levels[pageLevels - 1];
+    for(int i = 0; i < coarsest.pagesX * coarsest.pagesY; i++)
+    {
+        makeResident(coarsest.firstPage + i);
+    }
+    updatePageTable();
+}
+
+VirtualTexture::~VirtualTexture()
+{
+    GLState::forgetTexture(pageTable);
+    GLState::forgetTexture(pageStorage);
+    glDeleteTextures(1, &pageTable);
+    glDeleteTextures(1, &pageStorage);
+}
+
+GLint VirtualTexture::sparsePageSizeIndex(int& size)
+{
+    GLint count = 0;
+    glGetInternalformativ(GL_TEXTURE_2D, GL_RGBA8, GL_NUM_VIRTUAL_PAGE_SIZES_ARB, 1, &count);
+    if(count <= 0)
+    {
+        return -1;
+    }
+
+    std::vector<GLint> sizesX(count);
+    std::vector<GLint> sizesY(count);
+    glGetInternalformativ(GL_TEXTURE_2D, GL_RGBA8, GL_VIRTUAL_PAGE_SIZE_X_ARB, count, sizesX.data());
+    glGetInternalformativ(GL_TEXTURE_2D, GL_RGBA8, GL_VIRTUAL_PAGE_SIZE_Y_ARB, count, sizesY.data());
+
+    // the page table assumes square pages
+    for(GLint i = 0; i < count; i++)
+    {
+        if(sizesX[i] == sizesY[i] && std::has_single_bit((unsigned int) sizesX[i]))
+        {
+            size = sizesX[i];
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool VirtualTexture::load(const std::string& path)
+{
+    int sourceWidth, sourceHeight, numChannels;
+    unsigned char* pixels = stbi_load(path.c_str(), &sourceWidth, &sourceHeight, &numChannels, 4);
+    if(!pixels)
+    {
+        return false;
+    }
+
+    // powers of two so every level splits into whole pages, and at least a page
+    width = std::max((int) std::bit_ceil((unsigned int) sourceWidth), pageSize);
+    height = std::max((int) std::bit_ceil((unsigned int) sourceHeight), pageSize);
+
+    Level base {width, height, 0, 0, 0};
+    if(width == sourceWidth && height == sourceHeight)
+    {
+        base.texels.assign(pixels, pixels + (std::size_t) width * height * 4);
+    }
+    else
+    {
+        base.texels = resample(pixels, sourceWidth, sourceHeight, width, height);
+    }
+    stbi_image_free(pixels);
+
+    levels.clear();
+    levels.push_back(std::move(base));
+    while(levels.back().width > 1 || levels.back().height > 1)
+    {
+        const Level& previous = levels.back();
+        Level next {std::max(previous.width / 2, 1), std::max(previous.height / 2, 1), 0, 0, 0};
+        next.texels = downsample(previous.texels, previous.width, previous.height);
+        levels.push_back(std::move(next));
+    }
+    return true;
+}
+
+int VirtualTexture::createSparse(GLint pageSizeIndex)
+{
+    glGenTextures(1, &pageStorage);
+    GLState::bindTexture(GL_TEXTURE_2D, pageStorage);
+
+    // has to be set before the storage is allocated
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+    glTexParameteri(GL_TEXTURE_2D, GL_VIRTUAL_PAGE_SIZE_INDEX_ARB, pageSizeIndex);
+    glTexStorage2D(GL_TEXTURE_2D, (GLsizei) levels.size(), GL_RGBA8, width, height);
+
+    // levels past these are smaller than a page, they share the mip tail
+    GLint sparseLevels = 0;
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_NUM_SPARSE_LEVELS_ARB, &sparseLevels);
+    if(sparseLevels <= 0)
+    {
+        std::cout << "ERROR::VIRTUAL_TEXTURE::NO_SPARSE_LEVELS using the page cache\n";
+        GLState::forgetTexture(pageStorage);
+        glDeleteTextures(1, &pageStorage);
+        pageStorage = 0;
+        return 0;
+    }
+
+    // the mip tail is committed as a whole through any of its levels, and stays
+    if(sparseLevels < (GLint) levels.size())
+    {
+        const Level& tail = levels[sparseLevels];
+        GLExtensions::glTexPageCommitmentARB(GL_TEXTURE_2D, sparseLevels, 0, 0, 0, tail.width, tail.height, 1, GL_TRUE);
+        for(std::size_t level = sparseLevels; level < levels.size(); level++)
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, (GLint) level, 0, 0, levels[level].width, levels[level].height,
+                            GL_RGBA, GL_UNSIGNED_BYTE, levels[level].texels.data());
+        }
+    }
+    return sparseLevels;
+}
+
+void VirtualTexture::createPages(int maxPageLevels)
+{
+    // levels until the whole level fits into a page
+    int pagesX = width / pageSize;
+    int pagesY = height / pageSize;
+    pageLevels = std::min((int) std::bit_width((unsigned int) std::max(pagesX, pagesY)), maxPageLevels);
+
+    pages.clear();
+    for(int level = 0; level < pageLevels; level++)
+    {
+        Level& l = levels[level];
+        l.pagesX = std::max(pagesX >> level, 1);
+        l.pagesY = std::max(pagesY >> level, 1);
+        l.firstPage = pages.size();
+        for(int y = 0; y < l.pagesY; y++)
+        {
+            for(int x = 0; x < l.pagesX; x++)
+            {
+                pages.push_back({level, x, y});
+            }
+        }
+    }
+
+    // room for the pinned level and at least one page on top
+    const Level& coarsest = levels[pageLevels - 1];
+    maxResidentPages = std::max(maxResidentPages, coarsest.pagesX * coarsest.pagesY + 1);
+}
+
+void VirtualTexture::createCache()
+{
+    // slots are addressed by 8 bit page table entries
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    int stride = pageSize + 2 * PAGE_BORDER;
+    slotsPerSide = std::min({(int) std::ceil(std::sqrt((double) maxResidentPages)), maxSize / stride, 255});
+    maxResidentPages = std::min(maxResidentPages, slotsPerSide * slotsPerSide);
+    slots.assign((std::size_t) slotsPerSide * slotsPerSide, -1);
+
+    glGenTextures(1, &pageStorage);
+    GLState::bindTexture(GL_TEXTURE_2D, pageStorage);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, slotsPerSide * stride, slotsPerSide * stride);
+}
+
+void VirtualTexture::createPageTable()
+{
+    glGenTextures(1, &pageTable);
+    GLState::bindTexture(GL_TEXTURE_2D, pageTable);
+    glTexStorage2D(GL_TEXTURE_2D, pageLevels, GL_RGBA8UI, levels[0].pagesX, levels[0].pagesY);
+}
+
+std::size_t VirtualTexture::pageIndex(int level, int x, int y) const
+{
+    return levels[level].firstPage + (std::size_t) y * levels[level].pagesX + x;
+}
+
+void VirtualTexture::request(const std::vector<GLuint>& feedback)
+{
+    for(GLuint packed : feedback)
+    {
+        if(packed == NO_REQUEST)
+        {
+            continue;
+        }
+
+        int level = (int) (packed >> 24);
+        int x = (int) (packed & 0xFFF);
+        int y = (int) ((packed >> 12) & 0xFFF);
+        if(level >= pageLevels || x >= levels[level].pagesX || y >= levels[level].pagesY)
+        {
+            continue;
+        }
+
+        // the coarser pages are what's sampled until this one is loaded, so they're used too
+        for(; level < pageLevels; level++, x /= 2, y /= 2)
+        {
+            std::size_t index = pageIndex(level, x, y);
+            Page& page = pages[index];
+            if(page.lastUsed == frame)
+            {
+                break;
+            }
+
+            page.lastUsed = frame;
+            if(!page.resident && !page.queued)
+            {
+                page.queued = true;
+                queue.push_back(index);
+            }
+        }
+    }
+}
+
+void VirtualTexture::update(int maxPages)
+{
+    // coarse pages first, they stand in for all the pages below them
+    std::sort(queue.begin(), queue.end(), [this](std::size_t a, std::size_t b)
+    {
+        return pages[a].level > pages[b].level;
+    });
+
+    int loaded = 0;
+    bool full = false;
+    for(std::size_t index : queue)
+    {
+        pages[index].queued = false;
+        if(full || loaded == maxPages || pages[index].resident)
+        {
+            continue;
+        }
+
+        // every resident page is in use, nothing to evict
+        if(makeResident(index))
+        {
+            loaded++;
+        }
+        else
+        {
+            full = true;
+        }
+    }
+
+    // whatever didn't make it is requested again by the next feedback
+    queue.clear();
+
+    if(pageTableDirty && pageTable)
+    {
+        updatePageTable();
+    }
+    frame++;
+}
+
+bool VirtualTexture::makeResident(std::size_t index)
+{
+    if(residentPages >= maxResidentPages)
+    {
+        // least recently requested, finer levels first. the coarsest level and pages in use stay
+        std::ptrdiff_t victim = -1;
+        for(std::size_t i = 0; i < pages.size(); i++)
+        {
+            const Page& page = pages[i];
+            if(!page.resident || page.level == pageLevels - 1 || page.lastUsed >= frame)
+            {
+                continue;
+            }
+            if(victim < 0 || page.lastUsed < pages[victim].lastUsed
+               || (page.lastUsed == pages[victim].lastUsed && page.level < pages[victim].level))
+            {
+                victim = (std::ptrdiff_t) i;
+            }
+        }
+
+        if(victim < 0)
+        {
+            return false;
+        }
+        evict(victim);
+    }
+
+    Page& page = pages[index];
+    const Level& level = levels[page.level];
+    int pageWidth = std::min(pageSize, level.width);
+    int pageHeight = std::min(pageSize, level.height);
+
+    std::vector<unsigned char> texels;
+    GLState::bindTexture(GL_TEXTURE_2D, pageStorage);
+
+    if(sparse)
+    {
+        copyPage(page, 0, texels);
+        GLExtensions::glTexPageCommitmentARB(GL_TEXTURE_2D, page.level, page.x * pageSize, page.y * pageSize, 0,
+                                             pageWidth, pageHeight, 1, GL_TRUE);
+        glTexSubImage2D(GL_TEXTURE_2D, page.level, page.x * pageSize, page.y * pageSize, pageWidth, pageHeight,
+                        GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    }
+    else
+    {
+        auto slot = std::find(slots.begin(), slots.end(), -1);
+        page.slot = (int) (slot - slots.begin());
+        *slot = (std::ptrdiff_t) index;
+
+        copyPage(page, PAGE_BORDER, texels);
+        int stride = pageSize + 2 * PAGE_BORDER;
+        glTexSubImage2D(GL_TEXTURE_2D, 0, (page.slot % slotsPerSide) * stride, (page.slot / slotsPerSide) * stride,
+                        pageWidth + 2 * PAGE_BORDER, pageHeight + 2 * PAGE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE,
+                        texels.data());
+    }
+
+    page.resident = true;
+    residentPages++;
+    pageTableDirty = true;
+    return true;
+}
+
+void VirtualTexture::evict(std::size_t index)
+{
+    Page& page = pages[index];
+    if(sparse)
+    {
+        const Level& level = levels[page.level];
+        GLState::bindTexture(GL_TEXTURE_2D, pageStorage);
+        GLExtensions::glTexPageCommitmentARB(GL_TEXTURE_2D, page.level, page.x * pageSize, page.y * pageSize, 0,
+                                             std::min(pageSize, level.width), std::min(pageSize, level.height), 1,
+                                             GL_FALSE);
+    }
+    else
+    {
+        slots[page.slot] = -1;
+        page.slot = -1;
+    }
+
+    page.resident = false;
+    residentPages--;
+    pageTableDirty = true;
+}
+
+void VirtualTexture::copyPage(const Page& page, int border, std::vector<unsigned char>& out) const
+{
+    const Level& level = levels[page.level];
+    int pageWidth = std::min(pageSize, level.width) + 2 * border;
+    int pageHeight = std::min(pageSize, level.height) + 2 * border;
+    out.resize((std::size_t) pageWidth * pageHeight * 4);
+
+    // the border wraps around like the texture does
+    for(int y = 0; y < pageHeight; y++)
+    {
+        int sourceY = ((page.y * pageSize + y - border) % level.height + level.height) % level.height;
+        for(int x = 0; x < pageWidth; x++)
+        {
+            int sourceX = ((page.x * pageSize + x - border) % level.width + level.width) % level.width;
+            std::copy_n(level.texels.begin() + ((std::ptrdiff_t) sourceY * level.width + sourceX) * 4, 4,
+                        out.begin() + ((std::ptrdiff_t) y * pageWidth + x) * 4);
+        }
+    }
+}
+
+void VirtualTexture::updatePageTable()
+{
+    GLState::bindTexture(GL_TEXTURE_2D, pageTable);
+
+    // coarsest first, pages that aren't resident copy the entry of the page above them
+    std::vector<std::vector<GLubyte>> entries(pageLevels);
+    for(int level = pageLevels - 1; level >= 0; level--)
+    {
+        const Level& l = levels[level];
+        entries[level].resize((std::size_t) l.pagesX * l.pagesY * 4);
+
+        for(int y = 0; y < l.pagesY; y++)
+        {
+            for(int x = 0; x < l.pagesX; x++)
+            {
+                const Page& page = pages[pageIndex(level, x, y)];
+                GLubyte* entry = &entries[level][((std::size_t) y * l.pagesX + x) * 4];
+                if(page.resident)
+                {
+                    entry[0] = (GLubyte) (sparse ? 0 : page.slot % slotsPerSide);
+                    entry[1] = (GLubyte) (sparse ? 0 : page.slot / slotsPerSide);
+                    entry[2] = (GLubyte) level;
+                    entry[3] = 0;
+                }
+                else
+                {
+                    const Level& above = levels[level + 1];
+                    std::copy_n(&entries[level + 1][((std::size_t) (y / 2) * above.pagesX + x / 2) * 4], 4, entry);
+                }
+            }
+        }
+
+        glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, l.pagesX, l.pagesY, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE,
+                        entries[level].data());
+    }
+    pageTableDirty = false;
+}
+
+void VirtualTexture::use(GLuint pageTableUnit, GLuint pageStorageUnit) const
+{
+    // integer textures are only complete with nearest filtering
+    static const SamplerState pageTableSampler {GL_NEAREST_MIPMAP_NEAREST, GL_NEAREST, GL_CLAMP_TO_EDGE,
+                                                GL_CLAMP_TO_EDGE};
+    // the cache filters inside a page's border, its own mips and repeat would mix in other pages
+    static const SamplerState cacheSampler {GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE};
+
+    GLState::bindTexture(pageTableUnit, GL_TEXTURE_2D, pageTable);
+    SamplerCache::bind(pageTableUnit, pageTableSampler);
+    GLState::bindTexture(pageStorageUnit, GL_TEXTURE_2D, pageStorage);
+    SamplerCache::bind(pageStorageUnit, sparse ? SamplerCache::defaults : cacheSampler);
+}
+
+void VirtualTexture::describe(VirtualTextureData& data, float feedbackLodBias) const
+{
+    data.virtualSize = glm::vec2(width, height);
+    data.pageCount = levels.empty() ? glm::vec2(0) : glm::vec2(levels[0].pagesX, levels[0].pagesY);
+    data.pageSize = (float) pageSize;
+    data.pageBorder = sparse ? 0.0f : (float) PAGE_BORDER;
+    data.cacheSize = (float) (slotsPerSide * (pageSize + 2 * PAGE_BORDER));
+    data.pageLevels = pageLevels;
+    data.sparse = sparse ? 1 : 0;
+    data.feedbackLodBias = feedbackLodBias;
+}
@@ -0,0 +1,126 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+#ifndef LEARNOPENGL_VIRTUALTEXTURE_H
+#define LEARNOPENGL_VIRTUALTEXTURE_H
+
+#include "UniformBlocks.h"
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// texture split into square pages per mip level, of which only the ones the feedback pass asked for are in
+// video memory. a page table texture tells the shader where each page is, or which coarser page to use
+// while it isn't loaded yet. pages are committed in a sparse texture when the context has ARB_sparse_texture,
+// otherwise copied into the slots of a page cache texture. either way at most maxResidentPages are resident,
+// the least recently requested ones make room for new ones
+class VirtualTexture
+{
+public:
+    // what the feedback shader writes where no virtual texture was drawn
+    static constexpr GLuint NO_REQUEST = 0xFFFFFFFF;
+
+    // page table (RGBA8UI) and the sparse texture or page cache
+    GLuint pageTable;
+    GLuint pageStorage;
+    bool sparse;
+
+    // level 0, resampled to powers of two (and at least a page) on load
+    int width;
+    int height;
+    int pageSize;
+    int pageLevels;
+
+    // pages resident right now, including the pinned coarsest level
+    int residentPages;
+
+    // png/jpg decoded with stb_image, the whole mip chain stays in system memory to copy pages from.
+    // the coarsest page level is resident from the start so there's always something to sample
+    explicit VirtualTexture(const std::string& path, int maxResidentPages = 256);
+    ~VirtualTexture();
+
+    VirtualTexture(const VirtualTexture&) = delete;
+    VirtualTexture& operator=(const VirtualTexture&) = delete;
+
+    // queues the pages in a feedback readback (packed by the feedback shader) and their coarser levels,
+    // and marks them used for eviction
+    void request(const std::vector<GLuint>& feedback);
+
+    // loads up to maxPages queued pages, coarsest first, and updates the page table. call once per frame
+    void update(int maxPages = 8);
+
+    void use(GLuint pageTableUnit, GLuint pageStorageUnit) const;
+
+    // the block the shaders read the layout from
+    void describe(VirtualTextureData& data, float feedbackLodBias) const;
+
+private:
+    // page size of the software page cache, and the texels copied around each page in it
+    static constexpr int PAGE_SIZE = 128;
+    static constexpr int PAGE_BORDER = 4;
+
+    struct Page
+    {
+        int level;
+        int x;
+        int y;
+        bool resident = false;
+        bool queued = false;
+        // slot in the page cache, unused for sparse pages
+        int slot = -1;
+        std::uint64_t lastUsed = 0;
+    };
+
+    struct Level
+    {
+        int width;
+        int height;
+        int pagesX;
+        int pagesY;
+        // first page of the level in pages
+        std::size_t firstPage;
+        std::vector<unsigned char> texels;
+    };
+
+    std::vector<Level> levels;
+    std::vector<Page> pages;
+    std::vector<std::size_t> queue;
+    // lastUsed of pages never requested stays 0
+    std::uint64_t frame = 1;
+    int maxResidentPages;
+    bool pageTableDirty = true;
+
+    // page cache slots: page in each one, -1 for free
+    int slotsPerSide = 0;
+    std::vector<std::ptrdiff_t> slots;
+
+    // index of a square page size the implementation has for sparse rgba8 textures (size in size), -1 if none
+    static GLint sparsePageSizeIndex(int& size);
+
+    bool load(const std::string& path);
+
+    // number of levels that are committed page by page, 0 if the sparse texture couldn't be made
+    int createSparse(GLint pageSizeIndex);
+    void createPages(int maxPageLevels);
+    void createCache();
+    void createPageTable();
+
+    [[nodiscard]] std::size_t pageIndex(int level, int x, int y) const;
+
+    // commits/copies the page, evicting the least recently used one when the budget is spent.
+    // false if every resident page was used this frame
+    bool makeResident(std::size_t index);
+    void evict(std::size_t index);
+
+    // rgba8 texels of the page, with the border around it when it goes into the cache
+    void copyPage(const Page& page, int border, std::vector<unsigned char>& out) const;
+
+    void updatePageTable();
+};
+
+#endif //LEARNOPENGL_VIRTUALTEXTURE_H
@@ -1,10 +1,34 @@
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
 #include "glad/glad.h"
 #include "glfw/include/GLFW/glfw3.h"
 #include "helpers/Shader.h"
+#include "helpers/ShaderLibrary.h"
+#include "helpers/GLExtensions.h"
+#include "helpers/ShaderWatcher.h"
+#include "helpers/GLState.h"
 #include "stb/stb_image.h"
 #include "helpers/Texture2D.h"
+#include "helpers/TextureArray.h"
+#include "helpers/TextureStreamer.h"
+#include "helpers/BindlessTextures.h"
+#include "helpers/VirtualTexture.h"
+#include "helpers/FeedbackBuffer.h"
+#include "helpers/SceneFramebuffer.h"
+#include "helpers/TextureBudget.h"
+#include "helpers/SamplerCache.h"
+#include "helpers/ResourceManager.h"
 #include "helpers/Camera.h"
+#include "helpers/FrustumCuller.h"
+#include "helpers/InstanceBuffer.h"
+#include "helpers/IndirectDraws.h"
+#include "helpers/UniformBuffer.h"
+#include "helpers/UniformBlocks.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -33,8 +57,69 @@ bool firstMouse = true;
 float fov = 45;
 Camera camera { Camera()};
 
-int main()
+int main(int argc, char** argv)
 {
+    // --hot-reload recompiles shaders when files in shaders/ change
+    // --spirv loads the modules the spirv target compiled instead of compiling the glsl
+    // --bindless samples the material maps through bindless handles instead of a bound array texture
+    // --virtual-texture streams the diffuse map's pages in as a feedback pass asks for them
+    // --texture-budget <MB> trims the mips of textures that weren't used for a while above that much memory
+    // --anisotropy <n> samples every texture with up to n times anisotropic filtering
+    // --reverse-z renders with reverse-Z depth, an infinite far plane and a float depth buffer
+    // --instanced draws the cubes with one instanced draw per material instead of a draw each
+    // --cubes <n> adds cubes on a grid below the first ten, up to n in total
+    // --gpu-driven culls the cubes in a compute shader and draws them with one multi draw indirect, over --instanced
+    bool hotReload = false;
+    bool spirv = false;
+    bool bindless = false;
+    bool virtualTexturing = false;
+    bool reverseZ = false;
+    bool instanced = false;
+    bool gpuDriven = false;
+    int cubeCount = 10;
+    for(int i = 1; i < argc; i++)
+    {
+        if(std::strcmp(argv[i], "--hot-reload") == 0)
+        {
+            hotReload = true;
+        }
+        if(std::strcmp(argv[i], "--spirv") == 0)
+        {
+            spirv = true;
+        }
+        if(std::strcmp(argv[i], "--bindless") == 0)
+        {
+            bindless = true;
+        }
+        if(std::strcmp(argv[i], "--virtual-texture") == 0)
+        {
+            virtualTexturing = true;
+        }
+        if(std::strcmp(argv[i], "--reverse-z") == 0)
+        {
+            reverseZ = true;
+        }
+        if(std::strcmp(argv[i], "--instanced") == 0)
+        {
+            instanced = true;
+        }
+        if(std::strcmp(argv[i], "--gpu-driven") == 0)
+        {
+            gpuDriven = true;
+        }
+        if(std::strcmp(argv[i], "--cubes") == 0 && i + 1 < argc)
+        {
+            cubeCount = std::max(std::atoi(argv[++i]), 10);
+        }
+        if(std::strcmp(argv[i], "--texture-budget") == 0 && i + 1 < argc)
+        {
+            TextureBudget::budget = std::strtoull(argv[++i], nullptr, 10) * 1024 * 1024;
+        }
+        if(std::strcmp(argv[i], "--anisotropy") == 0 && i + 1 < argc)
+        {
+            SamplerCache::defaults.maxAnisotropy = std::strtof(argv[++i], nullptr);
+        }
+    }
 
     if(!glfwInit())
     {
@@ -72,14 +157,111 @@ int main()
         return -1;
     }
 
+    GLExtensions::load((GLADloadproc) glfwGetProcAddress);
+
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
     // shaders are also represented with objects/ids
-    Shader basicShader {"../shaders/basic_lighting_shader.vert"
-                            , "../shaders/basic_lighting_shader.frag"};
+    // all programs are submitted up front and compile in the background while the rest loads
+    ShaderLibrary shaders;
+    if(spirv)
+    {
+        spirv = shaders.useSpirv("spirv/");
+    }
 
-    Shader basicLightShader {"../shaders/basic_light_shader.vert"
-            , "../shaders/basic_light_shader.frag"};
+    // the bound array texture is used when handles aren't available. the SPIR-V modules are built
+    // without the extension
+    if(bindless && (!BindlessTextures::supported() || spirv))
+    {
+        std::cout << "bindless textures aren't available" << (spirv ? " with SPIR-V" : "")
+                  << ", binding the material maps instead\n";
+        bindless = false;
+    }
+
+    // clip control is core since 4.5. the default framebuffer's depth is fixed point, so the scene is drawn
+    // into one with a float depth buffer and copied to the screen
+    if(reverseZ && !GLAD_GL_VERSION_4_5)
+    {
+        std::cout << "reverse-Z needs OpenGL 4.5, using the standard depth range\n";
+        reverseZ = false;
+    }
+
+    std::unique_ptr<SceneFramebuffer> sceneFramebuffer;
+    if(reverseZ)
+    {
+        glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+        glDepthFunc(GL_GREATER);
+        glClearDepth(0.0);
+        camera.setDepthMode(Camera::DepthMode::REVERSE_Z);
+        sceneFramebuffer = std::make_unique<SceneFramebuffer>();
+    }
+    const float farDepth = reverseZ ? 0.0f : 1.0f;
+
+    // compute shaders and indirect draws are core since 4.3, gl_DrawID and gl_BaseInstance since 4.6
+    if(gpuDriven && !GLAD_GL_VERSION_4_6)
+    {
+        std::cout << "gpu driven rendering needs OpenGL 4.6, culling on the cpu instead\n";
+        gpuDriven = false;
+    }
+    instanced = instanced && !gpuDriven;
+
+    ShaderDefines litFragmentDefines {{"SPECULAR_MAP", "1"}};
+    if(bindless)
+    {
+        litFragmentDefines["BINDLESS"] = "1";
+    }
+    if(virtualTexturing)
+    {
+        litFragmentDefines["VIRTUAL_TEXTURE"] = "1";
+    }
+    if(gpuDriven)
+    {
+        litFragmentDefines["GPU_DRIVEN"] = "1";
+    }
+
+    // stages are separable programs combined through pipelines, so the lit vertex stage is compiled once
+    // and shared by the cubes and the light
+    const ShaderLibrary::ShaderId litVertexStage = shaders.submitStage(GL_VERTEX_SHADER
+            , "../shaders/basic_lighting_shader.vert");
+
+    const ShaderLibrary::ShaderId litFragmentStage = shaders.submitStage(GL_FRAGMENT_SHADER
+            , "../shaders/basic_lighting_shader.frag", litFragmentDefines);
+
+    const ShaderLibrary::ShaderId lightFragmentStage = shaders.submitStage(GL_FRAGMENT_SHADER
+            , "../shaders/basic_light_shader.frag");
+
+    // the lit vertex stage again, reading the cubes' matrices per instance
+    ShaderLibrary::ShaderId instancedVertexStage = 0;
+    if(instanced)
+    {
+        instancedVertexStage = shaders.submitStage(GL_VERTEX_SHADER, "../shaders/basic_lighting_shader.vert",
+                                                   {{"INSTANCED", "1"}});
+    }
+
+    // the lit vertex stage reading the cubes from the object buffer, and the compute shader that culls them
+    ShaderLibrary::ShaderId gpuDrivenVertexStage = 0;
+    ShaderLibrary::ShaderId cullStage = 0;
+    if(gpuDriven)
+    {
+        gpuDrivenVertexStage = shaders.submitStage(GL_VERTEX_SHADER, "../shaders/basic_lighting_shader.vert",
+                                                   {{"GPU_DRIVEN", "1"}});
+        cullStage = shaders.submitStage(GL_COMPUTE_SHADER, "../shaders/cull_objects.comp");
+    }
+    const ShaderLibrary::ShaderId cubeVertexStage = gpuDriven ? gpuDrivenVertexStage
+            : instanced ? instancedVertexStage : litVertexStage;
+
+    // draws the page requests of the virtual texture, with the cubes' vertex stage
+    ShaderLibrary::ShaderId feedbackFragmentStage = 0;
+    if(virtualTexturing)
+    {
+        feedbackFragmentStage = shaders.submitStage(GL_FRAGMENT_SHADER, "../shaders/virtual_texture_feedback.frag");
+    }
+
+    std::unique_ptr<ShaderWatcher> shaderWatcher;
+    if(hotReload)
+    {
+        shaderWatcher = std::make_unique<ShaderWatcher>("../shaders/");
+    }
 
     // *** Initialization of VAO starts here ***
     // vertices of triangle, each vertex has 3 values (x, y, z). z is zero here to make it look 2d
@@ -145,7 +327,7 @@ int main()
     glGenBuffers(1, &vbo);
 
     // bind vao before vbo to store vertex attrib
-    glBindVertexArray(vao);
+    GLState::bindVertexArray(vao);
 
     // binds type of buffer
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -189,12 +371,12 @@ int main()
     // *** Initialization of VAO ends here ***
 
     // unbind VAO so other can be created
-    glBindVertexArray(0);
+    GLState::bindVertexArray(0);
 
     GLuint lightVao;
 
     glGenVertexArrays(1, &lightVao);
-    glBindVertexArray(lightVao);
+    GLState::bindVertexArray(lightVao);
 
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
@@ -224,8 +406,50 @@ int main()
     // flips all loaded images on the y-axis when loading
     stbi_set_flip_vertically_on_load(true);
 
-    Texture2D container {"../textures/container2.png"};
-    Texture2D containerSpecular {"../textures/container2_specular.png"};
+    // baked by the bake_textures target (flipped, mipmapped, compressed), the source image is decoded
+    // when there is no baked file. bakes are BC1/BC3, which a context without s3tc can't sample
+    auto texturePath = [](const std::string& name, const std::string& source)
+    {
+        std::string baked = "textures/" + name + ".ktx2";
+        return GLExtensions::s3tc && std::filesystem::exists(baked) ? baked : source;
+    };
+
+    const std::string containerPath = texturePath("container2", "../textures/container2.png");
+    const std::string containerSpecularPath = texturePath("container2_specular", "../textures/container2_specular.png");
+
+    // every material's maps in one array texture, bound once for all cubes. its maps decode in the background
+    // and it's a grey placeholder until they're uploaded. in bindless mode they stay textures of their own
+    // that the materials reference by handle, nothing is bound at all
+    // files loaded more than once (under any name) share one texture
+    ResourceManager resources;
+    std::unique_ptr<TextureStreamer> textureStreamer;
+    TextureArray materialMaps;
+    std::vector<ResourceManager::TextureHandle> bindlessMaps;
+    TextureArray::Region containerDiffuse;
+    TextureArray::Region containerSpecular;
+    glm::uvec2 containerDiffuseHandle {0};
+    glm::uvec2 containerSpecularHandle {0};
+    if(bindless)
+    {
+        bindlessMaps.push_back(resources.loadTexture(containerPath));
+        bindlessMaps.push_back(resources.loadTexture(containerSpecularPath));
+
+        // a whole texture each
+        containerDiffuse.layer = 0;
+        containerSpecular.layer = 0;
+        if(bindlessMaps[0] && bindlessMaps[1])
+        {
+            containerDiffuseHandle = BindlessTextures::pack(bindlessMaps[0]->handle());
+            containerSpecularHandle = BindlessTextures::pack(bindlessMaps[1]->handle());
+        }
+    }
+    else
+    {
+        textureStreamer = std::make_unique<TextureStreamer>();
+        textureStreamer->load(materialMaps, {containerPath, containerSpecularPath});
+        containerDiffuse = materialMaps.regions[0];
+        containerSpecular = materialMaps.regions[1];
+    }
 
     glm::vec3 cubePositions[] = {
             glm::vec3( 0.0f,  0.0f,  0.0f),
@@ -242,6 +466,128 @@ int main()
 
     glm::vec3 lightCol = glm::vec3(1.0, .5, .75);
 
+    // uniforms are resolved once per program so the render loop never looks up names
+    // (again whenever the library's program for them changes)
+    struct VertexUniforms
+    {
+        GLuint program = 0;
+        UniformHandle<glm::mat4> model;
+        UniformHandle<glm::mat3> normalMat;
+    } vertexUniforms;
+
+    struct LitUniforms
+    {
+        GLuint program = 0;
+        UniformHandle<TextureArray> materialMaps;
+        UniformHandle<int> materialIndex;
+        UniformHandle<int> pageTable;
+        UniformHandle<int> pageStorage;
+    } lit;
+
+    struct LightUniforms
+    {
+        GLuint program = 0;
+        UniformHandle<glm::vec3> lightColor;
+    } light;
+
+    // camera and light uniforms shared by all programs, uploaded once per frame
+    UniformBuffer frameUniforms {FrameData::binding, sizeof(FrameData)};
+    FrameData frameData {};
+
+    // all materials in one block, uploaded once. the cubes alternate between a shiny container
+    // and a dull one without specular map, no binds or program changes in between
+    UniformBuffer materialUniforms {MaterialData::binding, sizeof(MaterialData)};
+    MaterialData materials {};
+
+    glsl::Material& shinyContainer = materials.materials[0];
+    shinyContainer.diffuseLayer = containerDiffuse.layer;
+    shinyContainer.diffuseRect = containerDiffuse.rect;
+    shinyContainer.diffuseHandle = containerDiffuseHandle;
+    shinyContainer.specularLayer = containerSpecular.layer;
+    shinyContainer.specularRect = containerSpecular.rect;
+    shinyContainer.specularHandle = containerSpecularHandle;
+    shinyContainer.specularColor = glm::vec3(0.5f);
+    shinyContainer.shininess = 64.0f;
+
+    glsl::Material& dullContainer = materials.materials[1];
+    dullContainer.diffuseLayer = containerDiffuse.layer;
+    dullContainer.diffuseRect = containerDiffuse.rect;
+    dullContainer.diffuseHandle = containerDiffuseHandle;
+    dullContainer.specularLayer = -1;
+    dullContainer.specularColor = glm::vec3(0.1f);
+    dullContainer.shininess = 8.0f;
+
+    materialUniforms.update(materials);
+
+    // the diffuse map once more as a virtual texture, only the pages the feedback pass sees get uploaded
+    std::unique_ptr<VirtualTexture> virtualTexture;
+    std::unique_ptr<FeedbackBuffer> feedback;
+    std::vector<GLuint> feedbackRequests;
+    UniformBuffer virtualTextureUniforms {VirtualTextureData::binding, sizeof(VirtualTextureData)};
+    if(virtualTexturing)
+    {
+        virtualTexture = std::make_unique<VirtualTexture>("../textures/container2.png");
+        feedback = std::make_unique<FeedbackBuffer>();
+
+        VirtualTextureData virtualTextureData {};
+        virtualTexture->describe(virtualTextureData, feedback->lodBias());
+        virtualTextureUniforms.update(virtualTextureData);
+    }
+
+    // the ten cubes above, then the rest of --cubes on a grid below them. they never move, so their matrices
+    // and a sphere around each are made once
+    std::vector<InstanceData> cubes((std::size_t) cubeCount);
+    const int gridSide = (int) std::ceil(std::sqrt((double) (cubeCount - 10)));
+    FrustumCuller culler;
+    for(int i = 0; i < cubeCount; i++)
+    {
+        glm::mat4 model = glm::identity<glm::mat4>();
+        if(i < 10)
+        {
+            model = glm::rotate(model, glm::radians((float)20 * i), glm::vec3(0, 1, 0));
+            model = glm::translate(model, cubePositions[i]);
+        }
+        else
+        {
+            const int cell = i - 10;
+            model = glm::translate(model, glm::vec3((float) (cell % gridSide - gridSide / 2) * 2.0f, -10.0f,
+                                                    (float) (cell / gridSide - gridSide / 2) * 2.0f));
+            model = glm::rotate(model, glm::radians((float)20 * i), glm::vec3(0, 1, 0));
+        }
+
+        cubes[i] = {model, glm::transpose(glm::inverse(glm::mat3(model)))};
+        culler.addSphere(glm::vec3(model[3]), 0.87f);
+    }
+
+    // the visible cubes' matrices, grouped by material, next to the vertex attributes in the cube vao
+    std::unique_ptr<InstanceBuffer> cubeInstances;
+    std::vector<InstanceData> visibleInstances;
+    GLsizei materialFirst[2] = {0, 0};
+    GLsizei materialCount[2] = {0, 0};
+    if(instanced)
+    {
+        cubeInstances = std::make_unique<InstanceBuffer>();
+        cubeInstances->attach(vao);
+    }
+
+    // every cube with its bounds and material, on the gpu for good
+    std::unique_ptr<IndirectDraws> gpuCubes;
+    if(gpuDriven)
+    {
+        std::vector<DrawObject> objects(cubes.size());
+        for(std::size_t i = 0; i < cubes.size(); i++)
+        {
+            objects[i].model = cubes[i].model;
+            objects[i].normalMat = glm::mat4(cubes[i].normalMat);
+            objects[i].boundingSphere = glm::vec4(glm::vec3(cubes[i].model[3]), 0.87f);
+            objects[i].material = (GLuint) (i % 2);
+        }
+        gpuCubes = std::make_unique<IndirectDraws>(objects, 2, 36);
+    }
+
+
+    // per frame counters are shown in the window title once a second
+    float lastStatsTime = 0.0f;
 
     while(!glfwWindowShouldClose(window))
     {
@@ -250,17 +596,84 @@ int main()
         float currentFrame = (float)glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
+
+        if(currentFrame - lastStatsTime >= 1.0f)
+        {
+            std::string title = "My Window | uniforms sent: " + std::to_string(Shader::frameStats.uploads)
+                    + " elided: " + std::to_string(Shader::frameStats.elided)
+                    + " | state changes sent: " + std::to_string(GLState::frameStats.issued)
+                    + " elided: " + std::to_string(GLState::frameStats.elided);
+            title += " | texture memory: " + std::to_string(TextureBudget::stats.current / (1024 * 1024))
+                    + " MB, peak " + std::to_string(TextureBudget::stats.peak / (1024 * 1024)) + " MB";
+            if(gpuCubes)
+            {
+                // the counts stay on the gpu, reading them back would stall
+                title += " | cubes: " + std::to_string(cubeCount) + " culled on the gpu";
+            }
+            else
+            {
+                title += " | cubes drawn: " + std::to_string(culler.stats.visible)
+                        + " culled: " + std::to_string(culler.stats.culled);
+            }
+            if(virtualTexture)
+            {
+                title += " | virtual pages: " + std::to_string(virtualTexture->residentPages);
+            }
+            glfwSetWindowTitle(window, title.c_str());
+            lastStatsTime = currentFrame;
+        }
+        Shader::frameStats = {};
+        GLState::frameStats = {};
         // input
         processInput(window);
 
-        glEnable(GL_DEPTH_TEST);
+        // picks up programs the driver finished compiling (and edited shaders in hot reload mode)
+        if(shaderWatcher)
+        {
+            shaders.reload(shaderWatcher->takeChanges());
+        }
+        shaders.poll();
+
+        // a few MB of texture uploads per frame, so streaming never causes a long frame. the materials
+        // point at the placeholder until the maps arrived, then at where they were put in the array
+        if(textureStreamer)
+        {
+            textureStreamer->update(4 * 1024 * 1024);
+            if(textureStreamer->idle())
+            {
+                shinyContainer.diffuseLayer = materialMaps.regions[0].layer;
+                shinyContainer.diffuseRect = materialMaps.regions[0].rect;
+                shinyContainer.specularLayer = materialMaps.regions[1].layer;
+                shinyContainer.specularRect = materialMaps.regions[1].rect;
+                dullContainer.diffuseLayer = materialMaps.regions[0].layer;
+                dullContainer.diffuseRect = materialMaps.regions[0].rect;
+                materialUniforms.update(materials);
+                textureStreamer.reset();
+            }
+        }
+
+        // mips of textures drawn last frame come back, cold ones are trimmed while over budget
+        TextureBudget::update();
+
+        int screenWidth, screenHeight;
+        glfwGetFramebufferSize(window, &screenWidth, &screenHeight);
+        if(sceneFramebuffer)
+        {
+            sceneFramebuffer->begin(screenWidth, screenHeight);
+        }
+
+        GLState::enable(GL_DEPTH_TEST);
 
         glClearColor(0.2, 0.3, 0.3, 1.0);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         // rendering here
 
 
-        glm::mat4 projection = glm::perspective(glm::radians(fov), 640 / 480.0f, 0.1f, 100.0f);
+        // only recomputed when the fov or the window's aspect changed. a minimized window keeps the last one
+        if(screenWidth > 0 && screenHeight > 0)
+        {
+            camera.setPerspective(fov, (float) screenWidth / (float) screenHeight, 0.1f, 100.0f);
+        }
 
         //glm::mat4 projection = glm::ortho(-aspect, aspect, -1.0f, 1.0f, 0.1f, 100.0f);
 
@@ -271,71 +684,246 @@ int main()
 
         // bind texture (maps to ourTexture uniform in frag shader)
         // Reuse VAO to prevent rebinding data to VBO
-        glBindVertexArray(vao);
+        GLState::bindVertexArray(vao);
         //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
         // draw triangle
         //glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
 
-        glm::mat4 view = camera.getView();
+        // the frame reads this copy, not the camera
+        const Camera::Snapshot view = camera.snapshot();
+
+        frameData.projection = view.projection;
+        frameData.view = view.view;
+        frameData.viewPos = view.position;
+        frameData.light.position = lightPos;
+        frameData.light.ambient = glm::vec3(0.3f);
+        frameData.light.diffuse = glm::vec3(0.75f);
+        frameData.light.specular = glm::vec3(1);
+        std::copy(std::begin(view.frustum.planes), std::end(view.frustum.planes), frameData.frustumPlanes);
+        frameUniforms.update(frameData);
+
+        // only the cubes in view are drawn, by every pass. on the gpu driven path the compute shader culls them,
+        // and they're skipped until it has compiled
+        const bool gpuCulled = gpuCubes && shaders.isReady(cullStage);
+        if(gpuCulled)
+        {
+            gpuCubes->cull(shaders.get(cullStage).ID);
+        }
+        static const std::vector<std::uint32_t> noCubes;
+        const std::vector<std::uint32_t>& visibleCubes = gpuCubes ? noCubes : culler.cull(view.frustum);
 
-        basicShader.use();
+        if(instanced)
+        {
+            visibleInstances.clear();
+            for(int material = 0; material < 2; material++)
+            {
+                materialFirst[material] = (GLsizei) visibleInstances.size();
+                for(std::uint32_t i : visibleCubes)
+                {
+                    if((int) i % 2 == material)
+                    {
+                        visibleInstances.push_back(cubes[i]);
+                    }
+                }
+                materialCount[material] = (GLsizei) visibleInstances.size() - materialFirst[material];
+            }
+            cubeInstances->update(visibleInstances);
+        }
 
-        glm::mat4 model = glm::identity<glm::mat4>();
+        // 0 while a stage is still compiling, the fallback program is drawn instead
+        const GLuint litPipeline = shaders.pipeline(cubeVertexStage, litFragmentStage);
+        const GLuint lightPipeline = shaders.pipeline(litVertexStage, lightFragmentStage);
+
+        const Shader& vertexStage = shaders.get(litVertexStage);
+        const Shader& litFragment = shaders.get(litFragmentStage);
+        const Shader& lightFragment = shaders.get(lightFragmentStage);
 
-        for(int i = 0; i < 10; i++)
+        if(shaders.isReady(litVertexStage) && vertexUniforms.program != vertexStage.ID)
         {
-            model = glm::identity<glm::mat4>();
+            vertexUniforms.program = vertexStage.ID;
+            vertexUniforms.model = vertexStage.getUniform<glm::mat4>("model");
+            vertexUniforms.normalMat = vertexStage.getUniform<glm::mat3>("normalMat");
+        }
 
-            model = glm::rotate(model, glm::radians((float)20 * i), glm::vec3(0, 1, 0));
+        if(shaders.isReady(litFragmentStage) && lit.program != litFragment.ID)
+        {
+            lit.program = litFragment.ID;
+            if(!bindless)
+            {
+                lit.materialMaps = litFragment.getUniform<TextureArray>("materialMaps");
+            }
+            lit.materialIndex = litFragment.getUniform<int>("materialIndex");
+            if(virtualTexture)
+            {
+                lit.pageTable = litFragment.getUniform<int>("pageTable");
+                lit.pageStorage = litFragment.getUniform<int>("pageStorage");
+            }
+        }
 
-            model = glm::translate(model, cubePositions[i]);
+        if(shaders.isReady(lightFragmentStage) && light.program != lightFragment.ID)
+        {
+            light.program = lightFragment.ID;
+            light.lightColor = lightFragment.getUniform<glm::vec3>("lightColor");
+        }
 
-            glm::mat3 normalMat = glm::transpose(glm::inverse(model));
+        // pages asked for by an earlier frame's feedback are loaded, then this frame's feedback is drawn
+        if(virtualTexture)
+        {
+            if(feedback->read(feedbackRequests))
+            {
+                virtualTexture->request(feedbackRequests);
+            }
+            virtualTexture->update();
+
+            const GLuint feedbackPipeline = shaders.pipeline(cubeVertexStage, feedbackFragmentStage);
+            if(feedbackPipeline)
+            {
+                feedback->begin(screenWidth, screenHeight, farDepth);
+
+                GLState::bindProgramPipeline(feedbackPipeline);
+                if(gpuCulled)
+                {
+                    gpuCubes->draw();
+                }
+                else if(instanced)
+                {
+                    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, (GLsizei) visibleInstances.size());
+                }
+                else
+                {
+                    for(std::uint32_t i : visibleCubes)
+                    {
+                        vertexStage.set(vertexUniforms.model, cubes[i].model);
+                        glDrawArrays(GL_TRIANGLES, 0, 36);
+                    }
+                }
+                feedback->end(sceneFramebuffer ? sceneFramebuffer->framebuffer : 0);
+            }
+        }
 
-            basicShader.setMat4("model", model);
-            basicShader.setMat4("projection", projection);
-            basicShader.setMat4("view", view);
-            basicShader.setMat3("normalMat", normalMat);
+        if(litPipeline)
+        {
+            GLState::bindProgramPipeline(litPipeline);
+        }
+        else
+        {
+            shaders.fallback.use();
+        }
 
-            basicShader.setVec3("viewPos", camera.getCameraPos());
+        glm::mat4 model = glm::identity<glm::mat4>();
 
-            basicShader.setTexture2D("material.diffuse", 0, container);
-            basicShader.setTexture2D("material.specular", 1, containerSpecular);
-            basicShader.setFloat("material.shininess", 64.0);
+        auto useLitTextures = [&]()
+        {
+            if(!bindless)
+            {
+                litFragment.set(lit.materialMaps, 0, materialMaps);
+            }
+
+            if(virtualTexture)
+            {
+                virtualTexture->use(1, 2);
+                litFragment.set(lit.pageTable, 1);
+                litFragment.set(lit.pageStorage, 2);
+            }
+        };
+
+        // every material in one multi draw, the compute shader filled in the commands
+        if(litPipeline && gpuCulled)
+        {
+            useLitTextures();
+            gpuCubes->draw();
+        }
+        // every visible cube of a material in one draw, the instances of each material are contiguous
+        else if(litPipeline && instanced)
+        {
+            useLitTextures();
+            for(int material = 0; material < 2; material++)
+            {
+                if(materialCount[material] == 0)
+                {
+                    continue;
+                }
+                litFragment.set(lit.materialIndex, material);
+                glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, 36, materialCount[material],
+                                                  (GLuint) materialFirst[material]);
+            }
+        }
+        else
+        {
+            for(std::uint32_t i : visibleCubes)
+            {
+                model = cubes[i].model;
+
+                if(!litPipeline)
+                {
+                    shaders.fallback.set(shaders.fallbackModel, model);
+                    glDrawArrays(GL_TRIANGLES, 0, 36);
+                    continue;
+                }
 
-            basicShader.setVec3("light.ambient", glm::vec3(0.3f));
-            basicShader.setVec3("light.diffuse", glm::vec3(0.75f));
-            basicShader.setVec3("light.specular", glm::vec3(1));
-            basicShader.setVec3("light.position",  lightPos);
+                vertexStage.set(vertexUniforms.model, model);
+                vertexStage.set(vertexUniforms.normalMat, cubes[i].normalMat);
 
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+                useLitTextures();
+                litFragment.set(lit.materialIndex, (int) i % 2);
+
+                glDrawArrays(GL_TRIANGLES, 0, 36);
+            }
         }
 
-        glBindVertexArray(lightVao);
-        basicLightShader.use();
+        GLState::bindVertexArray(lightVao);
 
         model = glm::identity<glm::mat4>();
 
         model = glm::translate(model, lightPos);
 
-        basicLightShader.setMat4("model", model);
-        basicLightShader.setMat4("projection", projection);
-        basicLightShader.setMat4("view", view);
-
-        basicLightShader.setVec3("lightColor", lightCol);
+        if(lightPipeline)
+        {
+            GLState::bindProgramPipeline(lightPipeline);
+            vertexStage.set(vertexUniforms.model, model);
+            lightFragment.set(light.lightColor, lightCol);
+        }
+        else
+        {
+            shaders.fallback.use();
+            shaders.fallback.set(shaders.fallbackModel, model);
+        }
 
         glDrawArrays(GL_TRIANGLES, 0, 36);
 
+        if(sceneFramebuffer)
+        {
+            sceneFramebuffer->end();
+        }
+
+        // textures whose last handle went away are deleted once the gpu is past the frames using them
+        resources.endFrame();
+
         // check/call events and swap buffers
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
     // deallocate resources
+    GLState::forgetVertexArray(vao);
+    GLState::forgetVertexArray(lightVao);
     glDeleteVertexArrays(1, &vao);
     glDeleteVertexArrays(1, &lightVao);
     glDeleteBuffers(1, &vbo);
 
+    // textures are deleted by their destructors, which has to happen while the context is still there
+    textureStreamer.reset();
+    bindlessMaps.clear();
+    resources.clear();
+    materialMaps.release();
+    virtualTexture.reset();
+    feedback.reset();
+    sceneFramebuffer.reset();
+    cubeInstances.reset();
+    gpuCubes.reset();
+    SamplerCache::clear();
+    shaders.clear();
+
     // cleans up and terminates glfw
     glfwDestroyWindow(window);
     glfwTerminate();
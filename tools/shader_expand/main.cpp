@@ -0,0 +1,54 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+// build step: runs a shader through ShaderPreprocessor (includes expanded, no defines injected)
+// and writes the result, so an offline compiler that doesn't know our #include can turn it into SPIR-V.
+// variants are picked later through specialization constants instead of defines.
+//
+// usage: shader_expand <shader> <output>
+
+#include "../../src/helpers/ShaderPreprocessor.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv)
+{
+    if(argc != 3)
+    {
+        std::cerr << "usage: shader_expand <shader> <output>\n";
+        return 1;
+    }
+
+    bool failed = false;
+    auto reader = [&failed](const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if(!file)
+        {
+            std::cerr << path << ": error: can't read file\n";
+            failed = true;
+        }
+
+        std::stringstream stream;
+        stream << file.rdbuf();
+        return stream.str();
+    };
+
+    ShaderPreprocessor::Result result = ShaderPreprocessor::process(argv[1], {}, reader);
+    if(failed)
+    {
+        return 1;
+    }
+
+    fs::path output = argv[2];
+    fs::create_directories(output.parent_path());
+    std::ofstream file(output, std::ios::binary);
+    file << result.source;
+    return file ? 0 : 1;
+}
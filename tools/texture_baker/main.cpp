@@ -0,0 +1,519 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+// build step: decodes images once and writes GPU-ready KTX2 files, so loading one at runtime is a read and
+// an upload. images are flipped like stbi_set_flip_vertically_on_load(true) would, the whole mip chain is
+// box filtered in linear space (sse), and --bc compresses every level to BC1 (opaque) or BC3 (with alpha).
+// files and mip levels are spread over all cores.
+//
+// usage: texture_baker [--bc] <output directory> <image>...
+
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BAKER_SSE
+#endif
+
+namespace fs = std::filesystem;
+
+// KTX2 VkFormat values we write
+static constexpr std::uint32_t VK_FORMAT_R8G8B8A8_UNORM = 37;
+static constexpr std::uint32_t VK_FORMAT_BC1_RGB_UNORM_BLOCK = 131;
+static constexpr std::uint32_t VK_FORMAT_BC3_UNORM_BLOCK = 137;
+
+struct Level
+{
+    int width;
+    int height;
+
+    // rgba, linear (or raw for data maps) 0..1
+    std::vector<float> texels;
+
+    // what goes in the file: rgba8 or BC blocks
+    std::vector<unsigned char> encoded;
+};
+
+struct Image
+{
+    fs::path source;
+    fs::path output;
+
+    // color maps are filtered in linear space, data maps (specular, normal...) as they are
+    bool srgb = true;
+    bool opaque = true;
+    bool failed = false;
+
+    std::vector<Level> levels;
+};
+
+static float srgbToLinear[256];
+
+// linear 0..1 quantized to 12 bits -> sRGB byte
+static unsigned char linearToSrgb[4096];
+
+static void buildTables()
+{
+    for(int i = 0; i < 256; i++)
+    {
+        float c = i / 255.0f;
+        srgbToLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    for(int i = 0; i < 4096; i++)
+    {
+        float c = i / 4095.0f;
+        float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1 / 2.4f) - 0.055f;
+        linearToSrgb[i] = (unsigned char) std::lround(std::clamp(s, 0.0f, 1.0f) * 255);
+    }
+}
+
+static unsigned char encodeChannel(float value, bool srgb)
+{
+    value = std::clamp(value, 0.0f, 1.0f);
+    return srgb ? linearToSrgb[(int) (value * 4095 + 0.5f)] : (unsigned char) std::lround(value * 255);
+}
+
+// runs work(0..count-1) on every core
+static void parallelFor(std::size_t count, const std::function<void(std::size_t)>& work)
+{
+    std::atomic<std::size_t> next = 0;
+    auto worker = [&]()
+    {
+        for(std::size_t i = next++; i < count; i = next++)
+        {
+            work(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+    for(unsigned int i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+// 2x2 box filter, odd sizes repeat their last row/column
+static Level downsample(const Level& source)
+{
+    Level level {std::max(1, source.width / 2), std::max(1, source.height / 2), {}, {}};
+    level.texels.resize((std::size_t) level.width * level.height * 4);
+
+    for(int y = 0; y < level.height; y++)
+    {
+        const float* row0 = &source.texels[(std::size_t) std::min(2 * y, source.height - 1) * source.width * 4];
+        const float* row1 = &source.texels[(std::size_t) std::min(2 * y + 1, source.height - 1) * source.width * 4];
+        float* out = &level.texels[(std::size_t) y * level.width * 4];
+
+        for(int x = 0; x < level.width; x++)
+        {
+            int x0 = std::min(2 * x, source.width - 1) * 4;
+            int x1 = std::min(2 * x + 1, source.width - 1) * 4;
+#ifdef BAKER_SSE
+            // one rgba texel per register
+            __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1)),
+                                    _mm_add_ps(_mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1)));
+            _mm_storeu_ps(out + x * 4, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+            for(int c = 0; c < 4; c++)
+            {
+                out[x * 4 + c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]) * 0.25f;
+            }
+#endif
+        }
+    }
+    return level;
+}
+
+static std::uint16_t toRgb565(const unsigned char* color)
+{
+    return std::uint16_t((color[0] >> 3) << 11 | (color[1] >> 2) << 5 | color[2] >> 3);
+}
+
+static void fromRgb565(std::uint16_t packed, int* color)
+{
+    color[0] = (packed >> 11 & 31) * 255 / 31;
+    color[1] = (packed >> 5 & 63) * 255 / 63;
+    color[2] = (packed & 31) * 255 / 31;
+}
+
+// BC1 color block from 16 rgba texels: endpoints at the corners of the bounding box, nearest palette entry per texel
+static void encodeColorBlock(const unsigned char (&block)[16][4], unsigned char* out)
+{
+    unsigned char low[3] = {255, 255, 255};
+    unsigned char high[3] = {0, 0, 0};
+    for(const auto& texel : block)
+    {
+        for(int c = 0; c < 3; c++)
+        {
+            low[c] = std::min(low[c], texel[c]);
+            high[c] = std::max(high[c], texel[c]);
+        }
+    }
+
+    std::uint16_t color0 = toRgb565(high);
+    std::uint16_t color1 = toRgb565(low);
+
+    // color0 > color1 picks the four color mode
+    if(color0 < color1)
+    {
+        std::swap(color0, color1);
+    }
+
+    int palette[4][3];
+    fromRgb565(color0, palette[0]);
+    fromRgb565(color1, palette[1]);
+    for(int c = 0; c < 3; c++)
+    {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    std::uint32_t indices = 0;
+    if(color0 != color1)
+    {
+        for(int i = 0; i < 16; i++)
+        {
+            int best = 0;
+            int bestDistance = INT32_MAX;
+            for(int p = 0; p < 4; p++)
+            {
+                int distance = 0;
+                for(int c = 0; c < 3; c++)
+                {
+                    int d = block[i][c] - palette[p][c];
+                    distance += d * d;
+                }
+                if(distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+            indices |= std::uint32_t(best) << (2 * i);
+        }
+    }
+
+    std::memcpy(out, &color0, 2);
+    std::memcpy(out + 2, &color1, 2);
+    std::memcpy(out + 4, &indices, 4);
+}
+
+// BC3 alpha block: 8 interpolated values between the block's min and max alpha
+static void encodeAlphaBlock(const unsigned char (&block)[16][4], unsigned char* out)
+{
+    int alpha0 = 0;
+    int alpha1 = 255;
+    for(const auto& texel : block)
+    {
+        alpha0 = std::max<int>(alpha0, texel[3]);
+        alpha1 = std::min<int>(alpha1, texel[3]);
+    }
+
+    int palette[8] = {alpha0, alpha1};
+    for(int i = 1; i < 7; i++)
+    {
+        palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+    }
+
+    std::uint64_t indices = 0;
+    if(alpha0 != alpha1)
+    {
+        for(int i = 0; i < 16; i++)
+        {
+            int best = 0;
+            for(int p = 1; p < 8; p++)
+            {
+                if(std::abs(block[i][3] - palette[p]) < std::abs(block[i][3] - palette[best]))
+                {
+                    best = p;
+                }
+            }
+            indices |= std::uint64_t(best) << (3 * i);
+        }
+    }
+
+    out[0] = (unsigned char) alpha0;
+    out[1] = (unsigned char) alpha1;
+    for(int i = 0; i < 6; i++)
+    {
+        out[2 + i] = (unsigned char) (indices >> (8 * i));
+    }
+}
+
+// level's texels as rgba8, then as BC blocks if compress is set
+static void encodeLevel(Level& level, bool srgb, bool compress, bool opaque)
+{
+    std::vector<unsigned char> rgba((std::size_t) level.width * level.height * 4);
+    for(std::size_t i = 0; i < rgba.size(); i++)
+    {
+        // alpha is never gamma encoded
+        rgba[i] = encodeChannel(level.texels[i], srgb && i % 4 != 3);
+    }
+
+    if(!compress)
+    {
+        level.encoded = std::move(rgba);
+        return;
+    }
+
+    int blocksX = (level.width + 3) / 4;
+    int blocksY = (level.height + 3) / 4;
+    std::size_t blockSize = opaque ? 8 : 16;
+    level.encoded.resize(blocksX * blocksY * blockSize);
+
+    for(int by = 0; by < blocksY; by++)
+    {
+        for(int bx = 0; bx < blocksX; bx++)
+        {
+            // edge blocks repeat the last texels
+            unsigned char block[16][4];
+            for(int i = 0; i < 16; i++)
+            {
+                int x = std::min(bx * 4 + i % 4, level.width - 1);
+                int y = std::min(by * 4 + i / 4, level.height - 1);
+                std::memcpy(block[i], &rgba[((std::size_t) y * level.width + x) * 4], 4);
+            }
+
+            unsigned char* out = &level.encoded[(by * blocksX + bx) * blockSize];
+            if(!opaque)
+            {
+                encodeAlphaBlock(block, out);
+                out += 8;
+            }
+            encodeColorBlock(block, out);
+        }
+    }
+}
+
+static void decode(Image& image)
+{
+    int width, height, numChannels;
+    unsigned char* pixels = stbi_load(image.source.string().c_str(), &width, &height, &numChannels, 4);
+    if(!pixels)
+    {
+        std::cerr << image.source.generic_string() << ": error: " << stbi_failure_reason() << '\n';
+        image.failed = true;
+        return;
+    }
+
+    Level base {width, height, {}, {}};
+    base.texels.resize((std::size_t) width * height * 4);
+    for(std::size_t i = 0; i < base.texels.size(); i++)
+    {
+        bool alpha = i % 4 == 3;
+        base.texels[i] = image.srgb && !alpha ? srgbToLinear[pixels[i]] : pixels[i] / 255.0f;
+        image.opaque = image.opaque && (!alpha || pixels[i] == 255);
+    }
+    stbi_image_free(pixels);
+
+    // each level from the one above, down to 1x1
+    image.levels.push_back(std::move(base));
+    while(image.levels.back().width > 1 || image.levels.back().height > 1)
+    {
+        image.levels.push_back(downsample(image.levels.back()));
+    }
+}
+
+// basic data format descriptor of the format (khr df 1.3), preceded by its total size as the file wants it
+static std::vector<std::uint32_t> dataFormatDescriptor(std::uint32_t vkFormat)
+{
+    // a sample: bit offset, bit length - 1, channel id. lower 0 and upper all ones for its bit length
+    struct Sample
+    {
+        std::uint32_t bitOffset;
+        std::uint32_t bitLength;
+        std::uint32_t channel;
+    };
+
+    std::uint32_t colorModel;
+    std::uint32_t blockDimensions;
+    std::uint32_t bytesPlane0;
+    std::vector<Sample> samples;
+    if(vkFormat == VK_FORMAT_R8G8B8A8_UNORM)
+    {
+        // KHR_DF_MODEL_RGBSDA, one texel per block, alpha is channel 15
+        colorModel = 1;
+        blockDimensions = 0;
+        bytesPlane0 = 4;
+        samples = {{0, 7, 0}, {8, 7, 1}, {16, 7, 2}, {24, 7, 15}};
+    }
+    else if(vkFormat == VK_FORMAT_BC1_RGB_UNORM_BLOCK)
+    {
+        // KHR_DF_MODEL_BC1A, 4x4 blocks of one 64 bit color sample
+        colorModel = 128;
+        blockDimensions = 3 | 3 << 8;
+        bytesPlane0 = 8;
+        samples = {{0, 63, 0}};
+    }
+    else
+    {
+        // KHR_DF_MODEL_BC3, 4x4 blocks of 64 bits of alpha then 64 bits of color
+        colorModel = 130;
+        blockDimensions = 3 | 3 << 8;
+        bytesPlane0 = 16;
+        samples = {{0, 63, 15}, {64, 63, 0}};
+    }
+
+    auto blockSize = (std::uint32_t) (24 + 16 * samples.size());
+    // the formats are UNORM, so the transfer function is linear. primaries BT709, straight alpha
+    std::vector<std::uint32_t> dfd = {4 + blockSize, 0, 2 | blockSize << 16, colorModel | 1 << 8 | 1 << 16,
+                                      blockDimensions, bytesPlane0, 0};
+    for(const Sample& sample : samples)
+    {
+        std::uint32_t upper = sample.bitLength >= 31 ? 0xFFFFFFFF : (1u << (sample.bitLength + 1)) - 1;
+        dfd.insert(dfd.end(), {sample.bitOffset | sample.bitLength << 16 | sample.channel << 24, 0, 0, upper});
+    }
+    return dfd;
+}
+
+static bool write(const Image& image, bool compress)
+{
+    std::uint32_t vkFormat = !compress ? VK_FORMAT_R8G8B8A8_UNORM
+            : image.opaque ? VK_FORMAT_BC1_RGB_UNORM_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+
+    static const unsigned char identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+    constexpr std::size_t headerSize = 12 + 9 * 4 + 4 * 4 + 2 * 8;
+
+    std::uint32_t header[9] = {vkFormat, 1, (std::uint32_t) image.levels[0].width,
+                               (std::uint32_t) image.levels[0].height, 0, 0, 1,
+                               (std::uint32_t) image.levels.size(), 0};
+
+    // the level index (largest level first) is followed by the data format descriptor, then the levels,
+    // smallest first and each 16 byte aligned. no key/values or supercompression data
+    const std::vector<std::uint32_t> dfd = dataFormatDescriptor(vkFormat);
+    const std::size_t dfdOffset = headerSize + image.levels.size() * 24;
+    const std::uint32_t dfdIndex[4] = {(std::uint32_t) dfdOffset, (std::uint32_t) (dfd.size() * 4), 0, 0};
+
+    std::vector<std::uint64_t> levelIndex(image.levels.size() * 3);
+    std::size_t offset = dfdOffset + dfd.size() * 4;
+    for(std::size_t i = image.levels.size(); i-- > 0;)
+    {
+        const Level& level = image.levels[i];
+        offset = (offset + 15) / 16 * 16;
+        levelIndex[i * 3] = offset;
+        levelIndex[i * 3 + 1] = level.encoded.size();
+        levelIndex[i * 3 + 2] = level.encoded.size();
+        offset += level.encoded.size();
+    }
+
+    std::vector<unsigned char> file(offset, 0);
+    std::memcpy(file.data(), identifier, sizeof(identifier));
+    std::memcpy(file.data() + 12, header, sizeof(header));
+    std::memcpy(file.data() + 12 + sizeof(header), dfdIndex, sizeof(dfdIndex));
+    std::memcpy(file.data() + headerSize, levelIndex.data(), levelIndex.size() * sizeof(std::uint64_t));
+    std::memcpy(file.data() + dfdOffset, dfd.data(), dfd.size() * 4);
+    for(std::size_t i = 0; i < image.levels.size(); i++)
+    {
+        std::memcpy(file.data() + levelIndex[i * 3], image.levels[i].encoded.data(), image.levels[i].encoded.size());
+    }
+
+    // written next to the final name and renamed, a running build never sees half a file
+    fs::path temporary = image.output;
+    temporary += ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        out.write((const char*) file.data(), (std::streamsize) file.size());
+        if(!out)
+        {
+            std::cerr << temporary.generic_string() << ": error: can't write\n";
+            return false;
+        }
+    }
+    std::error_code error;
+    fs::rename(temporary, image.output, error);
+    if(error)
+    {
+        std::cerr << image.output.generic_string() << ": error: can't rename " << temporary.generic_string()
+                  << ": " << error.message() << '\n';
+        fs::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    bool compress = false;
+    int first = 1;
+    if(argc > 1 && std::strcmp(argv[1], "--bc") == 0)
+    {
+        compress = true;
+        first++;
+    }
+
+    if(argc - first < 2)
+    {
+        std::cerr << "usage: texture_baker [--bc] <output directory> <image>...\n";
+        return 1;
+    }
+
+    fs::path outputDirectory = argv[first];
+    std::error_code error;
+    fs::create_directories(outputDirectory, error);
+    if(error)
+    {
+        std::cerr << outputDirectory.generic_string() << ": error: can't create: " << error.message() << '\n';
+        return 1;
+    }
+
+    std::vector<Image> images;
+    for(int i = first + 1; i < argc; i++)
+    {
+        Image image;
+        image.source = argv[i];
+        image.output = outputDirectory / image.source.stem();
+        image.output += ".ktx2";
+
+        std::string name = image.source.stem().string();
+        image.srgb = name.find("_specular") == std::string::npos && name.find("_normal") == std::string::npos;
+        images.push_back(image);
+    }
+
+    buildTables();
+
+    // bottom row first, like the runtime's stb loads
+    stbi_set_flip_vertically_on_load(true);
+
+    // decoding and the mip chain per file, then encoding per (file, level)
+    parallelFor(images.size(), [&images](std::size_t i) { decode(images[i]); });
+
+    std::vector<std::pair<Image*, Level*>> levels;
+    for(Image& image : images)
+    {
+        for(Level& level : image.levels)
+        {
+            levels.emplace_back(&image, &level);
+        }
+    }
+    parallelFor(levels.size(), [&levels, compress](std::size_t i)
+    {
+        encodeLevel(*levels[i].second, levels[i].first->srgb, compress, levels[i].first->opaque);
+    });
+
+    bool failed = false;
+    for(const Image& image : images)
+    {
+        failed = image.failed || !write(image, compress) || failed;
+    }
+    return failed ? 1 : 0;
+}
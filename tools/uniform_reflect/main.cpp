@@ -0,0 +1,505 @@
+//
+// Created by ninja on 10/17/2026.
+//
+
+// build step: reads every shader in a directory, finds the std140 uniform blocks and writes
+// C++ structs with the same layout (plus static_asserts on every offset), so the renderer can
+// fill a block in C++ and upload it with one buffer write.
+//
+// layout(constant_id = N) constants are listed too, so SPIR-V modules can be specialized from
+// the same define names the text shaders use.
+//
+// usage: uniform_reflect <shader directory> <output header>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct Member
+{
+    std::string type;
+    std::string name;
+    // 0 if not an array
+    int arraySize = 0;
+};
+
+struct Struct
+{
+    std::string name;
+    std::vector<Member> members;
+    std::string file;
+};
+
+struct Block
+{
+    Struct body;
+    int binding = -1;
+};
+
+struct Constant
+{
+    int id;
+    std::string file;
+};
+
+// a member's place in the std140 layout, and the C++ type that reproduces it
+struct Layout
+{
+    std::size_t align;
+    std::size_t size;
+    std::string cppType;
+};
+
+static std::map<std::string, Struct> structs;
+static std::map<std::string, Block> blocks;
+static std::map<std::string, Constant> constants;
+static bool failed = false;
+
+static void error(const std::string& file, const std::string& message)
+{
+    std::cerr << file << ": error: " << message << '\n';
+    failed = true;
+}
+
+// strips comments and preprocessor lines, then splits into identifiers, numbers and single characters
+static std::vector<std::string> tokenize(const std::string& source)
+{
+    std::string text;
+    bool lineStart = true;
+    for(std::size_t i = 0; i < source.size(); i++)
+    {
+        if(source.compare(i, 2, "//") == 0)
+        {
+            while(i < source.size() && source[i] != '\n') i++;
+        }
+        else if(source.compare(i, 2, "/*") == 0)
+        {
+            std::size_t end = source.find("*/", i + 2);
+            i = end == std::string::npos ? source.size() : end + 1;
+            continue;
+        }
+        else if(lineStart && source[i] == '#')
+        {
+            // both branches of an #ifdef are kept, blocks shouldn't depend on defines
+            while(i < source.size() && source[i] != '\n') i++;
+        }
+
+        if(i >= source.size())
+        {
+            break;
+        }
+
+        text += source[i];
+        if(source[i] == '\n')
+        {
+            lineStart = true;
+        }
+        else if(!std::isspace((unsigned char) source[i]))
+        {
+            lineStart = false;
+        }
+    }
+
+    std::vector<std::string> tokens;
+    for(std::size_t i = 0; i < text.size();)
+    {
+        unsigned char c = text[i];
+        if(std::isspace(c))
+        {
+            i++;
+        }
+        else if(std::isalnum(c) || c == '_')
+        {
+            std::size_t start = i;
+            while(i < text.size() && (std::isalnum((unsigned char) text[i]) || text[i] == '_')) i++;
+            tokens.push_back(text.substr(start, i - start));
+        }
+        else
+        {
+            tokens.emplace_back(1, (char) c);
+            i++;
+        }
+    }
+    return tokens;
+}
+
+static bool isQualifier(const std::string& token)
+{
+    static const char* qualifiers[] = {"highp", "mediump", "lowp", "precise", "row_major", "column_major"};
+    return std::find(std::begin(qualifiers), std::end(qualifiers), token) != std::end(qualifiers);
+}
+
+// parses "{ type name[N], other; ... }" starting at the brace, leaves i after the closing brace
+static std::vector<Member> parseMembers(const std::vector<std::string>& tokens, std::size_t& i, const std::string& file)
+{
+    std::vector<Member> members;
+    i++; // {
+
+    while(i < tokens.size() && tokens[i] != "}")
+    {
+        if(tokens[i] == "layout")
+        {
+            while(i < tokens.size() && tokens[i] != ")") i++;
+            i++;
+            continue;
+        }
+        if(isQualifier(tokens[i]))
+        {
+            i++;
+            continue;
+        }
+
+        std::string type = tokens[i++];
+        while(i < tokens.size() && tokens[i] != ";")
+        {
+            Member member;
+            member.type = type;
+            member.name = tokens[i++];
+
+            if(i < tokens.size() && tokens[i] == "[")
+            {
+                member.arraySize = std::atoi(tokens[i + 1].c_str());
+                if(member.arraySize <= 0)
+                {
+                    error(file, "array " + member.name + " needs a literal size");
+                }
+                i += 3;
+            }
+            members.push_back(member);
+
+            if(i < tokens.size() && tokens[i] == ",")
+            {
+                i++;
+            }
+        }
+        i++; // ;
+    }
+    i++; // }
+    return members;
+}
+
+static void parseFile(const fs::path& path)
+{
+    std::ifstream file(path);
+    std::stringstream stream;
+    stream << file.rdbuf();
+
+    std::string fileName = path.generic_string();
+    std::vector<std::string> tokens = tokenize(stream.str());
+
+    for(std::size_t i = 0; i < tokens.size(); i++)
+    {
+        if(tokens[i] == "struct" && i + 2 < tokens.size() && tokens[i + 2] == "{")
+        {
+            Struct parsed;
+            parsed.name = tokens[i + 1];
+            parsed.file = fileName;
+            i += 2;
+            parsed.members = parseMembers(tokens, i, fileName);
+            structs[parsed.name] = parsed;
+            continue;
+        }
+
+        if(tokens[i] != "layout")
+        {
+            continue;
+        }
+
+        // layout ( qualifiers ) uniform Name {
+        bool std140 = false;
+        int binding = -1;
+        int constantId = -1;
+        std::size_t j = i + 2;
+        for(; j < tokens.size() && tokens[j] != ")"; j++)
+        {
+            if(tokens[j] == "std140")
+            {
+                std140 = true;
+            }
+            if(tokens[j] == "binding" && j + 2 < tokens.size())
+            {
+                binding = std::atoi(tokens[j + 2].c_str());
+            }
+            if(tokens[j] == "constant_id" && j + 2 < tokens.size())
+            {
+                constantId = std::atoi(tokens[j + 2].c_str());
+            }
+        }
+
+        // layout ( constant_id = N ) const type NAME
+        if(constantId >= 0 && j + 3 < tokens.size() && tokens[j + 1] == "const")
+        {
+            const std::string& name = tokens[j + 3];
+            for(const auto& [otherName, other] : constants)
+            {
+                if((otherName == name) != (other.id == constantId))
+                {
+                    error(fileName, "specialization constant " + name + " (" + std::to_string(constantId)
+                                    + ") clashes with " + otherName + " (" + std::to_string(other.id)
+                                    + ") in " + other.file + ", ids and names have to match everywhere");
+                }
+            }
+            constants[name] = {constantId, fileName};
+            i = j + 3;
+            continue;
+        }
+
+        if(!std140 || j + 3 >= tokens.size() || tokens[j + 1] != "uniform" || tokens[j + 3] != "{")
+        {
+            continue;
+        }
+
+        Block block;
+        block.binding = binding;
+        block.body.name = tokens[j + 2];
+        block.body.file = fileName;
+        i = j + 3;
+        block.body.members = parseMembers(tokens, i, fileName);
+
+        if(blocks.contains(block.body.name))
+        {
+            error(fileName, "uniform block " + block.body.name + " is also declared in "
+                            + blocks[block.body.name].body.file + ", move it to a shared include");
+            continue;
+        }
+        blocks[block.body.name] = block;
+    }
+}
+
+static std::size_t roundUp(std::size_t value, std::size_t align)
+{
+    return (value + align - 1) / align * align;
+}
+
+static Layout layoutOf(const std::string& type, const std::string& file);
+
+static Layout structLayout(const Struct& body)
+{
+    std::size_t offset = 0;
+    std::size_t align = 16;
+    for(const Member& member : body.members)
+    {
+        Layout layout = layoutOf(member.type, body.file);
+        if(member.arraySize > 0)
+        {
+            // array elements are padded to vec4
+            layout.align = roundUp(layout.align, 16);
+            layout.size = roundUp(layout.size, 16) * member.arraySize;
+        }
+        offset = roundUp(offset, layout.align) + layout.size;
+        align = std::max(align, layout.align);
+    }
+    return {align, roundUp(offset, align), body.name};
+}
+
+static Layout layoutOf(const std::string& type, const std::string& file)
+{
+    static const std::map<std::string, Layout> basic = {
+            {"float", {4, 4, "float"}},
+            {"int", {4, 4, "std::int32_t"}},
+            {"uint", {4, 4, "std::uint32_t"}},
+            // GLSL bools are 4 bytes in buffers
+            {"bool", {4, 4, "std::uint32_t"}},
+            {"vec2", {8, 8, "glm::vec2"}},
+            {"vec3", {16, 12, "glm::vec3"}},
+            {"vec4", {16, 16, "glm::vec4"}},
+            {"ivec2", {8, 8, "glm::ivec2"}},
+            {"ivec3", {16, 12, "glm::ivec3"}},
+            {"ivec4", {16, 16, "glm::ivec4"}},
+            {"uvec2", {8, 8, "glm::uvec2"}},
+            {"uvec3", {16, 12, "glm::uvec3"}},
+            {"uvec4", {16, 16, "glm::uvec4"}},
+            // matrices are arrays of column vectors, each padded to vec4
+            {"mat2", {16, 32, "Std140Mat2"}},
+            {"mat3", {16, 48, "Std140Mat3"}},
+            {"mat4", {16, 64, "glm::mat4"}},
+    };
+
+    auto it = basic.find(type);
+    if(it != basic.end())
+    {
+        return it->second;
+    }
+
+    auto nested = structs.find(type);
+    if(nested != structs.end())
+    {
+        return structLayout(nested->second);
+    }
+
+    error(file, "type " + type + " is not supported in std140 blocks");
+    return {4, 4, "float"};
+}
+
+// emits body as a C++ struct with explicit padding, asserts for every offset go to asserts
+static void emitStruct(std::ostream& out, std::ostream& asserts, const Struct& body, const Block* block)
+{
+    out << "struct " << body.name << "\n{\n";
+    if(block)
+    {
+        out << "    static constexpr const char* blockName = \"" << body.name << "\";\n";
+        if(block->binding >= 0)
+        {
+            out << "    static constexpr GLuint binding = " << block->binding << ";\n";
+        }
+        out << '\n';
+    }
+
+    std::size_t offset = 0;
+    int padCount = 0;
+    for(const Member& member : body.members)
+    {
+        Layout layout = layoutOf(member.type, body.file);
+        std::string cppType = layout.cppType;
+        if(member.arraySize > 0)
+        {
+            layout.align = roundUp(layout.align, 16);
+            layout.size = roundUp(layout.size, 16) * member.arraySize;
+            if(member.type != "mat4" && member.type != "vec4" && !structs.contains(member.type))
+            {
+                cppType = "Std140Element<" + cppType + ">";
+            }
+        }
+
+        std::size_t aligned = roundUp(offset, layout.align);
+        if(aligned != offset)
+        {
+            out << "    std::uint8_t _pad" << padCount++ << "[" << aligned - offset << "];\n";
+        }
+
+        out << "    " << cppType << ' ' << member.name;
+        if(member.arraySize > 0)
+        {
+            out << '[' << member.arraySize << ']';
+        }
+        out << ";\n";
+
+        asserts << "static_assert(offsetof(" << body.name << ", " << member.name << ") == " << aligned
+                << ", \"std140 offset of " << body.name << "::" << member.name << "\");\n";
+        offset = aligned + layout.size;
+    }
+
+    Layout whole = structLayout(body);
+    if(whole.size != offset)
+    {
+        out << "    std::uint8_t _pad" << padCount << "[" << whole.size - offset << "];\n";
+    }
+    out << "};\n\n";
+
+    asserts << "static_assert(sizeof(" << body.name << ") == " << whole.size
+            << ", \"std140 size of " << body.name << "\");\n";
+}
+
+// structs used by blocks, dependencies first
+static void collectStructs(const Struct& body, std::vector<std::string>& order)
+{
+    for(const Member& member : body.members)
+    {
+        auto nested = structs.find(member.type);
+        if(nested != structs.end() && std::find(order.begin(), order.end(), member.type) == order.end())
+        {
+            collectStructs(nested->second, order);
+            order.push_back(member.type);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if(argc != 3)
+    {
+        std::cerr << "usage: uniform_reflect <shader directory> <output header>\n";
+        return 1;
+    }
+
+    // sorted so the output only changes when the shaders do
+    std::vector<fs::path> files;
+    for(const auto& entry : fs::recursive_directory_iterator(argv[1]))
+    {
+        if(entry.is_regular_file())
+        {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    for(const fs::path& path : files)
+    {
+        parseFile(path);
+    }
+
+    std::vector<std::string> order;
+    for(const auto& [name, block] : blocks)
+    {
+        collectStructs(block.body, order);
+    }
+
+    std::stringstream out;
+    std::stringstream asserts;
+
+    out << "// generated by uniform_reflect from " << fs::path(argv[1]).filename().generic_string()
+        << "/, do not edit\n\n"
+        << "#ifndef LEARNOPENGL_SHADERBLOCKS_H\n"
+        << "#define LEARNOPENGL_SHADERBLOCKS_H\n\n"
+        << "#include <glad/glad.h>\n"
+        << "#include <glm/glm.hpp>\n\n"
+        << "#include <array>\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n\n"
+        << "namespace glsl\n{\n\n"
+        << "// array element padded to a vec4 slot\n"
+        << "template<typename T>\n"
+        << "struct alignas(16) Std140Element\n{\n    T value;\n};\n\n"
+        << "// matrix columns padded to vec4 slots\n"
+        << "struct Std140Mat2\n{\n    glm::vec4 columns[2];\n\n"
+        << "    Std140Mat2& operator=(const glm::mat2& mat)\n    {\n"
+        << "        columns[0] = glm::vec4(mat[0], 0, 0);\n"
+        << "        columns[1] = glm::vec4(mat[1], 0, 0);\n"
+        << "        return *this;\n    }\n};\n\n"
+        << "struct Std140Mat3\n{\n    glm::vec4 columns[3];\n\n"
+        << "    Std140Mat3& operator=(const glm::mat3& mat)\n    {\n"
+        << "        columns[0] = glm::vec4(mat[0], 0);\n"
+        << "        columns[1] = glm::vec4(mat[1], 0);\n"
+        << "        columns[2] = glm::vec4(mat[2], 0);\n"
+        << "        return *this;\n    }\n};\n\n";
+
+    for(const std::string& name : order)
+    {
+        emitStruct(out, asserts, structs[name], nullptr);
+    }
+    for(const auto& [name, block] : blocks)
+    {
+        emitStruct(out, asserts, block.body, &block);
+    }
+
+    out << "// layout(constant_id) constants, set from the define of the same name when a SPIR-V module is specialized\n"
+        << "struct SpecializationConstant\n{\n    const char* name;\n    GLuint id;\n};\n\n"
+        << "inline constexpr std::array<SpecializationConstant, " << constants.size() << "> specializationConstants\n{{\n";
+    for(const auto& [name, constant] : constants)
+    {
+        out << "    {\"" << name << "\", " << constant.id << "},\n";
+    }
+    out << "}};\n\n";
+
+    out << asserts.str() << "\n}\n\n#endif //LEARNOPENGL_SHADERBLOCKS_H\n";
+
+    if(failed)
+    {
+        return 1;
+    }
+
+    fs::path output = argv[2];
+    fs::create_directories(output.parent_path());
+    std::ofstream file(output);
+    file << out.str();
+    return file ? 0 : 1;
+}